@@ -0,0 +1,180 @@
+// heap allocations per quantity operation on an allocating big-number type,
+// against the same operation on the bare numbers; reported as a JSON array
+// usage: alloc [iterations]
+//   every allocation is counted through the replaced global operator new; an
+//   operation adding nothing over its bare counterpart has "extra":0
+
+#include <dimensional/si.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	unsigned long allocations = 0;
+}
+
+void *operator new( std::size_t n )
+{
+	++allocations;
+	if ( void *p = std::malloc( n ? n : 1 ) )
+		return p;
+	throw std::bad_alloc{};
+}
+void operator delete( void *p ) noexcept { std::free( p ); }
+void operator delete( void *p, std::size_t ) noexcept { std::free( p ); }
+
+namespace
+{
+	// unsigned big integer of 32-bit limbs, enough of one to be billed with
+	struct big
+	{
+		std::vector<std::uint32_t> limbs;
+
+		explicit big( std::uint64_t v = 0 )
+		{
+			limbs.reserve( 8 );
+			for ( ; v; v >>= 32 )
+				limbs.push_back( static_cast<std::uint32_t>( v ) );
+		}
+
+		big &operator+=( const big &o )
+		{
+			if ( limbs.size() < o.limbs.size() )
+				limbs.resize( o.limbs.size() );
+			std::uint64_t carry = 0;
+			for ( std::size_t i = 0; i < limbs.size(); ++i )
+			{
+				carry += limbs[i];
+				if ( i < o.limbs.size() )
+					carry += o.limbs[i];
+				limbs[i] = static_cast<std::uint32_t>( carry );
+				carry >>= 32;
+			}
+			if ( carry )
+				limbs.push_back( static_cast<std::uint32_t>( carry ) );
+			return *this;
+		}
+		big &operator*=( std::uint32_t m )
+		{
+			std::uint64_t carry = 0;
+			for ( auto &l : limbs )
+			{
+				carry += std::uint64_t{l} * m;
+				l = static_cast<std::uint32_t>( carry );
+				carry >>= 32;
+			}
+			if ( carry )
+				limbs.push_back( static_cast<std::uint32_t>( carry ) );
+			return *this;
+		}
+		big &operator/=( std::uint32_t d )
+		{
+			std::uint64_t rem = 0;
+			for ( auto i = limbs.size(); i-- > 0; )
+			{
+				rem = rem << 32 | limbs[i];
+				limbs[i] = static_cast<std::uint32_t>( rem / d );
+				rem %= d;
+			}
+			while ( !limbs.empty() && limbs.back() == 0 )
+				limbs.pop_back();
+			return *this;
+		}
+	};
+
+	// the rvalue operators reuse their operand's limbs
+	big operator+( const big &a, const big &b ) { big r = a; return r += b; }
+	big operator+( big &&a, const big &b ) { return std::move( a += b ); }
+	big operator+( const big &a, big &&b ) { return std::move( b += a ); }
+	big operator+( big &&a, big &&b ) { return std::move( a += b ); }
+	big operator*( const big &a, std::intmax_t m ) { big r = a; return r *= static_cast<std::uint32_t>( m ); }
+	big operator*( big &&a, std::intmax_t m ) { return std::move( a *= static_cast<std::uint32_t>( m ) ); }
+	big operator/( const big &a, std::intmax_t d ) { big r = a; return r /= static_cast<std::uint32_t>( d ); }
+	big operator/( big &&a, std::intmax_t d ) { return std::move( a /= static_cast<std::uint32_t>( d ) ); }
+	bool operator<( const big &a, const big &b )
+	{
+		if ( a.limbs.size() != b.limbs.size() )
+			return a.limbs.size() < b.limbs.size();
+		for ( auto i = a.limbs.size(); i-- > 0; )
+			if ( a.limbs[i] != b.limbs[i] )
+				return a.limbs[i] < b.limbs[i];
+		return false;
+	}
+
+	// allocations per call of f, over n calls on fresh operands from make
+	template<typename Make, typename F>
+	double per_op( unsigned long n, Make make, F f )
+	{
+		unsigned long total = 0;
+		for ( unsigned long i = 0; i < n; ++i )
+		{
+			auto operands = make();
+			const unsigned long before = allocations;
+			f( operands );
+			total += allocations - before;
+		}
+		return static_cast<double>( total ) / static_cast<double>( n );
+	}
+
+	// whether report() is yet to write the opening of the array
+	bool first = true;
+
+	template<typename MakeQ, typename FQ, typename MakeB, typename FB>
+	void report( const char *op, unsigned long n, MakeQ make_q, FQ with_q, MakeB make_b, FB bare )
+	{
+		const double q = per_op( n, make_q, with_q ), b = per_op( n, make_b, bare );
+		std::cout
+			<< (first ? "[\n" : ",\n")
+			<< "{\"op\":\"" << op << "\""
+			<< ",\"allocations\":" << q
+			<< ",\"bare\":" << b
+			<< ",\"extra\":" << q - b
+			<< "}";
+		first = false;
+	}
+}
+
+int main( int argc, char **argv )
+{
+	using namespace si;
+	const unsigned long n = argc > 1 ? std::strtoul( argv[1], nullptr, 10 ) : 100'000;
+
+	using kg_t = decltype(big{}*kg);
+	using g_t  = decltype(big{}*g);
+	const auto two  = []{ return std::make_pair( big{ 1ull << 40 }, big{ 3ull << 40 } ); };
+	const auto two_kg = []{ return std::make_pair( big{ 1ull << 40 }*kg, big{ 3ull << 40 }*kg ); };
+	const auto kg_g = []{ return std::make_pair( big{ 1ull << 40 }*kg, big{ 3ull << 40 }*g ); };
+	using bare_pair = std::pair<big, big>;
+
+	report( "a + b", n,
+		two_kg, []( std::pair<kg_t, kg_t> &p ){ auto r = p.first + p.second; },
+		two,    []( bare_pair &p ){ auto r = p.first + p.second; } );
+	report( "move(a) + move(b)", n,
+		two_kg, []( std::pair<kg_t, kg_t> &p ){ auto r = std::move(p.first) + std::move(p.second); },
+		two,    []( bare_pair &p ){ auto r = std::move(p.first) + std::move(p.second); } );
+	report( "move(a) + b, other scale", n,
+		kg_g, []( std::pair<kg_t, g_t> &p ){ auto r = std::move(p.first) + p.second; },
+		two,  []( bare_pair &p ){ auto r = std::move(p.first)*1000 + p.second; } );
+	report( "a < b", n,
+		two_kg, []( std::pair<kg_t, kg_t> &p ){ volatile bool r = p.first < p.second; (void)r; },
+		two,    []( bare_pair &p ){ volatile bool r = p.first < p.second; (void)r; } );
+	report( "a += move(b)", n,
+		two_kg, []( std::pair<kg_t, kg_t> &p ){ p.first += std::move(p.second); },
+		two,    []( bare_pair &p ){ p.first = std::move(p.first) + std::move(p.second); } );
+	report( "move(a).to(g)", n,
+		two_kg, []( std::pair<kg_t, kg_t> &p ){ auto r = std::move(p.first).to( g ); },
+		two,    []( bare_pair &p ){ auto r = std::move(p.first)*1000; } );
+	report( "g_t{ move(a) }", n,
+		two_kg, []( std::pair<kg_t, kg_t> &p ){ g_t r{ std::move(p.first) }; },
+		two,    []( bare_pair &p ){ auto r = std::move(p.first)*1000; } );
+	report( "move(x) * kg", n,
+		two, []( bare_pair &p ){ auto r = std::move(p.first)*kg; },
+		two, []( bare_pair &p ){ auto r = std::move(p.first); } );
+	std::cout << "\n]\n";
+}
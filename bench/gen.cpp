@@ -0,0 +1,112 @@
+
+// synthetic translation units scaling one axis of the template machinery
+// usage: gen <axis> <n>
+//   header     n: 0 for dimensional.hpp, 1 for si.hpp, 2 for si_fwd.hpp;
+//              nothing but the include
+//   factors    dimensions of n distinct fundamental factors
+//   chain      n unit multiplications/divisions in a row
+//   literal    64 '_' literals of n significant digits each
+//   quantity   n distinct quantity types, added pairwise
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	const char *const usage = "usage: gen header|factors|chain|literal|quantity <n>\n";
+
+	void header( std::ostream &o, unsigned n )
+	{
+		const char *const headers[] = { "dimensional.hpp", "si.hpp", "si_fwd.hpp" };
+		if ( n == 2 )
+			o << "#define DIMENSIONAL_NAMED_DIMENSIONS\n";
+		o << "#include <dimensional/" << headers[n < 3 ? n : 0] << ">\n";
+		o << "int main() {}\n";
+	}
+
+	void factors( std::ostream &o, unsigned n )
+	{
+		o << "#include <dimensional/dimensional.hpp>\n"
+		     "using dimensional::dimension;\n"
+		     "using dimensional::dimensionless;\n"
+		     "using namespace dimensional::constant_literals;\n";
+		for ( unsigned i = 0; i < n; ++i )
+			o << "struct tag" << i << ";\n";
+		// the same factors, multiplied in the opposite orders
+		o << "constexpr auto fwd = dimensionless";
+		for ( unsigned i = 0; i < n; ++i )
+			o << "\n\t* dimension<tag" << i << ">{}";
+		o << ";\nconstexpr auto rev = dimensionless";
+		for ( unsigned i = n; i-- > 0; )
+			o << "\n\t* (dimension<tag" << i << ">{}^2_)";
+		o << ";\n"
+		     "static_assert( fwd*fwd == rev, \"\" );\n"
+		     "static_assert( rev/fwd == fwd, \"\" );\n"
+		     "static_assert( (rev^(1_/2_)) == fwd, \"\" );\n"
+		     "int main() {}\n";
+	}
+
+	void chain( std::ostream &o, unsigned n )
+	{
+		o << "#include <dimensional/si.hpp>\n"
+		     "using namespace si;\n"
+		     "constexpr auto u0 = unit::m;\n";
+		const char *const units[] = { "kg", "s", "A", "unit::m", "K" };
+		for ( unsigned i = 0; i < n; ++i )
+			o << "constexpr auto u" << i+1 << " = u" << i
+			  << (i % 2 ? " / " : " * ") << units[i/2 % 5] << ";\n";
+		o << "static_assert( u" << n << ".dimension == u0.dimension"
+		  << (n % 2 ? "*kg" : "") << ", \"\" );\n"
+		     "int main() {}\n";
+	}
+
+	void literal( std::ostream &o, unsigned n )
+	{
+		o << "#include <dimensional/dimensional.hpp>\n"
+		     "using namespace dimensional::constant_literals;\n";
+		for ( unsigned i = 0; i < 64; ++i )
+		{
+			// distinct literals, so nothing is memoized across them
+			std::string digits = std::to_string( i+1 );
+			while ( digits.size() < n )
+				digits += char('0' + (digits.size()*7 + i) % 10);
+			digits.resize( n ? n : 1 );
+			o << "constexpr auto c" << i << " = " << digits.substr(0, n/2+1)
+			  << (n/2+1 < digits.size() ? "." + digits.substr(n/2+1) : "")
+			  << "_;\n";
+		}
+		o << "int main() {}\n";
+	}
+
+	void quantity( std::ostream &o, unsigned n )
+	{
+		o << "#include <dimensional/si.hpp>\n"
+		     "using dimensional::constant;\n"
+		     "double sink;\n"
+		     "int main()\n{\n";
+		for ( unsigned i = 0; i < n; ++i )
+			o << "\tauto q" << i << " = " << i << ".0*(constant<"
+			  << i+1 << ">{}*si::unit::m);\n";
+		for ( unsigned i = 0; i+1 < n; ++i )
+			o << "\tsink += (q" << i << " + q" << i+1 << ").count();\n";
+		o << "}\n";
+	}
+}
+
+int main( int argc, char **argv )
+{
+	if ( argc != 3 )
+		return std::cerr << usage, 2;
+
+	const std::string axis = argv[1];
+	const auto n = static_cast<unsigned>( std::strtoul(argv[2], nullptr, 10) );
+
+	if      ( axis == "header"   ) header  ( std::cout, n );
+	else if ( axis == "factors"  ) factors ( std::cout, n );
+	else if ( axis == "chain"    ) chain   ( std::cout, n );
+	else if ( axis == "literal"  ) literal ( std::cout, n );
+	else if ( axis == "quantity" ) quantity( std::cout, n );
+	else
+		return std::cerr << usage, 2;
+}
@@ -0,0 +1,149 @@
+// runs a compiler command and reports its cost as a line of JSON
+// usage: measure <axis> <n> <class-dump> -- <command>... [-- <count-flags>...]
+//   wall time and peak RSS come from the child's rusage, of the command as
+//   is; the counts come from a second run with the count flags appended,
+//   so that the dumps and reports they ask for aren't part of the cost:
+//   template instantiation time is scraped from g++'s -ftime-report on
+//   stderr, and the number of instantiated classes is counted in the
+//   -fdump-lang-class file, if any (both are null when the compiler doesn't
+//   provide them, or there are no count flags)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+	// first number after the colon of the -ftime-report line named so
+	std::string time_report_seconds( const std::string &report, const char *name )
+	{
+		std::istringstream lines{ report };
+		for ( std::string line; std::getline(lines, line); )
+		{
+			const auto at = line.find( name );
+			const auto colon = line.find( ':' );
+			if ( at == std::string::npos || colon == std::string::npos || colon < at )
+				continue;
+			std::istringstream fields{ line.substr(colon+1) };
+			double seconds;
+			if ( fields >> seconds )
+				return std::to_string( seconds );
+		}
+		return "null";
+	}
+
+	std::string class_count( const char *dump )
+	{
+		std::ifstream in{ dump };
+		if ( !in )
+			return "null";
+		unsigned long n = 0;
+		for ( std::string line; std::getline(in, line); )
+			n += line.compare( 0, 6, "Class " ) == 0;
+		return std::to_string( n );
+	}
+
+	std::string slurp( int fd )
+	{
+		std::string s;
+		char buf[4096];
+		for ( ssize_t n; (n = read(fd, buf, sizeof buf)) > 0; )
+			s.append( buf, static_cast<std::size_t>(n) );
+		return s;
+	}
+
+	struct run
+	{
+		bool ok;
+		double wall_s;
+		long peak_rss_kib;
+		std::string diag;
+	};
+
+	// argv, a null-terminated command, run with its stderr captured
+	run run_command( char **argv )
+	{
+		int err[2];
+		if ( pipe(err) != 0 )
+			std::perror("pipe"), std::exit( 1 );
+
+		const auto start = std::chrono::steady_clock::now();
+		const pid_t child = fork();
+		if ( child < 0 )
+			std::perror("fork"), std::exit( 1 );
+		if ( child == 0 )
+		{
+			dup2( err[1], STDERR_FILENO );
+			close( err[0] );
+			close( err[1] );
+			execvp( argv[0], argv );
+			std::perror( argv[0] );
+			_exit( 127 );
+		}
+		close( err[1] );
+		run res;
+		res.diag = slurp( err[0] );
+		close( err[0] );
+
+		int status;
+		struct rusage usage;
+		if ( wait4(child, &status, 0, &usage) != child )
+			std::perror("wait4"), std::exit( 1 );
+		const std::chrono::duration<double> wall =
+			std::chrono::steady_clock::now() - start;
+
+		res.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+		res.wall_s = wall.count();
+		// ru_maxrss is in KiB on Linux
+		res.peak_rss_kib = usage.ru_maxrss;
+		if ( !res.ok )
+			std::cerr << res.diag;
+		return res;
+	}
+}
+
+int main( int argc, char **argv )
+{
+	if ( argc < 6 || std::strcmp(argv[4], "--") != 0 )
+		return std::cerr << "usage: measure <axis> <n> <class-dump> -- <command>... [-- <count-flags>...]\n", 2;
+
+	// the command alone, then with the count flags in place of the "--"
+	std::vector<char *> command( argv+5, argv+argc );
+	const auto split = std::find_if( command.begin(), command.end(),
+		[]( const char *arg ){ return std::strcmp(arg, "--") == 0; } );
+	const bool counting = split != command.end() && split+1 != command.end();
+	std::vector<char *> counted = command;
+	if ( counting )
+		counted.erase( counted.begin() + (split - command.begin()) );
+	command.erase( split, command.end() );
+	command.push_back( nullptr );
+	counted.push_back( nullptr );
+
+	std::remove( argv[3] );
+	const run timed = run_command( command.data() );
+	const run counts = timed.ok && counting ? run_command( counted.data() ) : run{};
+	const std::string classes = class_count( argv[3] );
+	std::remove( argv[3] );
+
+	std::cout
+		<< "{\"axis\":\"" << argv[1] << "\",\"n\":" << argv[2]
+		<< ",\"ok\":" << (timed.ok ? "true" : "false")
+		<< ",\"wall_s\":" << timed.wall_s
+		<< ",\"peak_rss_kib\":" << timed.peak_rss_kib
+		<< ",\"instantiation_s\":" << time_report_seconds( counts.diag, "template instantiation" )
+		<< ",\"total_s\":" << time_report_seconds( counts.diag, "TOTAL" )
+		<< ",\"classes\":" << classes
+		<< "}\n";
+	return timed.ok ? 0 : 1;
+}
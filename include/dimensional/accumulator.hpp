@@ -0,0 +1,227 @@
+// compensated summation of quantities: long sums of small addends
+// without the precision loss of repeated +=
+
+#ifndef DIMENSIONAL_ACCUMULATOR_H
+#define DIMENSIONAL_ACCUMULATOR_H
+
+#include "bulk.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace dimensional
+{
+	namespace impl
+	{
+		// the running sum in the accumulator's unit, and the error term:
+		// Neumaier's compensation for floating point, with the error term
+		// renormalized against the sum after each addition, lest it grow in
+		// long sums and lose precision of its own
+		template<typename T, bool Floating = std::is_floating_point<T>::value>
+		struct compensated
+		{
+			T sum{}, comp{};
+
+			// a + b, and the rounding error of it into err
+			static T two_sum( T a, T b, T &err )
+			{
+				using std::abs;
+				const T t = a + b;
+				err = abs(a) >= abs(b) ? (a - t) + b : (b - t) + a;
+				return t;
+			}
+
+			void add( T x )
+			{
+				T err;
+				sum = two_sum( sum, x, err );
+				add_error( err );
+			}
+			// count*Num/Den, with the rounding of the scaling compensated too
+			template<typename TR>
+			void add( TR count, std::intmax_t num, std::intmax_t den )
+			{
+				const T x = static_cast<T>( count );
+				if ( num == 1 && den == 1 )
+					return add( x );
+				using std::fma;
+				const T n = static_cast<T>( num ), d = static_cast<T>( den );
+				const T p = x * n, p_err = fma( x, n, -p );
+				const T q = p / d, q_err = fma( -q, d, p );
+				add( q );
+				add_error( (p_err + q_err) / d );
+			}
+			void add( const compensated &o )
+			{
+				add( o.sum );
+				add_error( o.comp );
+			}
+			// err (of a sum made elsewhere) into the error term
+			void add_error( T err )
+			{
+				comp += err;
+				sum = two_sum( sum, comp, comp );
+			}
+			T total() const { return sum + comp; }
+		};
+
+		// for integers: the exact remainder of the scaling, rem/den,
+		// with 0 <= rem < den
+		template<typename T>
+		struct compensated<T, false>
+		{
+			T sum{};
+			std::intmax_t rem = 0, den = 1;
+
+			void add( T x ) { sum += x; }
+			template<typename TR>
+			void add( TR count, std::intmax_t num, std::intmax_t d )
+			{
+				static_assert( std::is_integral<TR>::value,
+					"compensating an integer sum for floating-point addends" );
+				const std::intmax_t p = static_cast<std::intmax_t>( count ) * num;
+				std::intmax_t whole = p / d, r = p % d;
+				if ( r < 0 )
+					r += d, --whole;
+				sum += static_cast<T>( whole );
+				add_fraction( r, d );
+			}
+			void add( const compensated &o )
+			{
+				sum += o.sum;
+				add_fraction( o.rem, o.den );
+			}
+			// rounded toward zero, as in quantity conversions
+			T total() const { return sum < 0 && rem != 0 ? sum + 1 : sum; }
+
+		private:
+			void add_fraction( std::intmax_t r, std::intmax_t d )
+			{
+				if ( r == 0 )
+					return;
+				std::intmax_t l, a, b;
+				if ( __builtin_mul_overflow( den / mjk::sgcd( den, d ), d, &l ) ||
+				     __builtin_mul_overflow( rem, l / den, &a ) ||
+				     __builtin_mul_overflow( r, l / d, &b ) ||
+				     __builtin_add_overflow( a, b, &a ) )
+				{
+					//   No common denominator in range (too many coprime scales):
+					// the finer of the two fractions is kept and the other one
+					// rounded down to it, off by less than a part of it.
+					if ( d > den )
+						std::swap( r, rem ), std::swap( d, den );
+					l = den;
+					b = static_cast<std::intmax_t>( static_cast<long double>( r ) * den / d );
+					a = b >= den - rem ? b - (den - rem) : rem + b;
+					if ( b >= den - rem )
+						sum += 1;
+				}
+				else if ( a >= l )
+					a -= l, sum += 1;
+				rem = a, den = l;
+				const std::intmax_t g = mjk::sgcd( rem, den );
+				if ( g > 1 )
+					rem /= g, den /= g;
+			}
+		};
+	}
+
+
+	// sum of quantities, with the error term of each addition kept aside in
+	// its unit, so that many small addends don't vanish in a large sum;
+	// addends of other scales are brought to it as by heterop
+	template<typename Quantity>
+	class accumulator;
+
+	template<typename T, typename Dim, typename Scale>
+	class accumulator< quantity< T, unit<Dim, Scale> > >
+	{
+		using unit_type = dimensional::unit<Dim, Scale>;
+
+		impl::compensated<T> acc;
+
+		// the factor from ScaleR to Scale, as a_scale / b_scale
+		template<typename ScaleR>
+		using factor = impl::common_scale<ScaleR, Scale>;
+
+	public:
+		using value_type = quantity<T, unit_type>;
+
+		accumulator() = default;
+		template<typename TR, typename UnitR>
+		accumulator( const quantity<TR, UnitR> &q ) { add( q ); }
+
+		template<typename TR, typename DimR, typename ScaleR>
+		accumulator &add( const quantity<TR, dimensional::unit<DimR, ScaleR>> &q )
+		{
+			static_assert( q.dimension == dimension,
+				"accumulating quantity with different dimension" );
+			acc.add( q.count(), factor<ScaleR>::a_scale::value, factor<ScaleR>::b_scale::value );
+			return *this;
+		}
+		accumulator &add( const accumulator &o )
+		{
+			acc.add( o.acc );
+			return *this;
+		}
+		// all of s; float and double are summed in vectors, lane by lane
+		template<typename TR, typename DimR, typename ScaleR>
+		accumulator &add( quantity_span<TR, dimensional::unit<DimR, ScaleR>> s )
+		{
+			static_assert( s.dimension == dimension,
+				"accumulating quantities with different dimension" );
+			using raw = std::remove_const_t<TR>;
+			using vectorized = std::integral_constant< bool,
+				std::is_same<raw, T>::value && impl::simd::has_lanes<T>::value &&
+				std::is_floating_point<T>::value >;
+			add_n<ScaleR>( s.data(), s.size(), vectorized{} );
+			return *this;
+		}
+
+		template<typename TR, typename UnitR>
+		accumulator &operator+=( const quantity<TR, UnitR> &q ) { return add( q ); }
+		template<typename TR, typename UnitR>
+		accumulator &operator-=( const quantity<TR, UnitR> &q ) { return add( -q.count() * q.unit ); }
+		accumulator &operator+=( const accumulator &o ) { return add( o ); }
+
+		// as reduction type, e.g. in std::accumulate or par::reduce
+		template<typename TR, typename UnitR>
+		friend accumulator operator+( accumulator a, const quantity<TR, UnitR> &q ) { return a += q; }
+		friend accumulator operator+( accumulator a, const accumulator &b ) { return a += b; }
+
+		// the sum, with the error term added in
+		value_type value() const { return value_type{ acc.total() }; }
+		operator value_type() const { return value(); }
+
+		static constexpr unit_type unit{};
+		static constexpr auto dimension = unit.dimension;
+		static constexpr auto scale = unit.scale;
+
+	private:
+		template<typename ScaleR, typename TR>
+		void add_n( const TR *p, std::size_t n, std::false_type )
+		{
+			for ( std::size_t i = 0; i < n; ++i )
+				acc.add( p[i], factor<ScaleR>::a_scale::value, factor<ScaleR>::b_scale::value );
+		}
+		template<typename ScaleR>
+		void add_n( const T *p, std::size_t n, std::true_type )
+		{
+			using f = factor<ScaleR>;
+			T sums[impl::simd::max_lanes], comps[impl::simd::max_lanes];
+			std::size_t lanes;
+			const std::size_t done = impl::simd::kahan_with< f::a_scale::value, f::b_scale::value >(
+				impl::simd::level(), p, n, sums, comps, lanes );
+			for ( std::size_t k = 0; k < lanes; ++k )
+			{
+				acc.add( sums[k] );
+				acc.add_error( -comps[k] );
+			}
+			add_n<ScaleR>( p + done, n - done, std::false_type{} );
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,256 @@
+// quantities of any data type and unit as one type, for containers of mixed
+// readings and the like: the count kept in place (on the heap only when too
+// big for it), the unit as a dyn_unit, and the way back to static
+// quantities checked at run time
+
+#ifndef DIMENSIONAL_ANY_H
+#define DIMENSIONAL_ANY_H
+
+#include "dynamic.hpp"
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+namespace dimensional
+{
+	// thrown for an any_quantity asked for a data type it doesn't hold
+	struct bad_any_quantity_cast : std::bad_cast
+	{
+		const char *what() const noexcept override
+		{ return "bad any_quantity cast"; }
+	};
+
+
+	namespace impl
+	{
+		// x*r with r known at run time only, rounded like scale_count would
+		template<typename I>
+		inline I rounded_by( const I &, const I &q, const I &, rounding::toward_zero ) noexcept
+		{ return q; }
+		template<typename I>
+		inline I rounded_by( const I &p, const I &q, const I &den, rounding::floor ) noexcept
+		{ return p < I{0} && p != q * den ? I(q - 1) : q; }
+		template<typename I>
+		inline I rounded_by( const I &p, const I &q, const I &den, rounding::ceil ) noexcept
+		{ return p > I{0} && p != q * den ? I(q + 1) : q; }
+		template<typename I>
+		inline I rounded_by( const I &p, const I &q, const I &den, rounding::nearest ) noexcept
+		{
+			const I r = I(p - q * den);
+			const uintmax_t mag = r < I{0} ? uintmax_t{0} - uintmax_t(r) : uintmax_t(r);
+			return mag == 0 || uintmax_t(den) - mag > mag ? q :
+				p < I{0} ? I(q - 1) : I(q + 1);
+		}
+
+		template<typename T, typename Mode>
+		inline auto scale_count_by( const T &x, rational r, std::true_type /*integer*/, Mode mode ) noexcept
+		{
+			using I = decltype( x * intmax_t{} );
+			const I p = static_cast<I>( static_cast<I>( x ) * static_cast<I>( r.num ) );
+			const I den = static_cast<I>( r.den );
+			return rounded_by( p, static_cast<I>( p / den ), den, mode );
+		}
+		template<typename T, typename Mode>
+		inline auto scale_count_by( const T &x, rational r, std::false_type /*floating*/, Mode ) noexcept
+		{
+			static_assert( std::is_same<Mode, rounding::toward_zero>::value,
+				"rounding floating-point conversion" );
+			using F = decltype( x * intmax_t{} );
+			return static_cast<F>( x ) * static_cast<F>( r.num ) / static_cast<F>( r.den );
+		}
+		template<typename T, typename Mode>
+		inline auto scale_count_by( const T &x, rational r, std::nullptr_t, Mode )
+		{
+			static_assert( std::is_same<Mode, rounding::toward_zero>::value,
+				"rounding conversion of non-integer data type" );
+			return x * r.num / r.den;
+		}
+
+
+		//   How an any_quantity handles the count it holds, one table per
+		// data type, its address telling the types apart. Counts of types
+		// trivially copyable and small enough are copied bytewise, with no
+		// calls through the table.
+		struct any_ops
+		{
+			bool trivial;
+			void (*copy)( const void *from, void *to );
+			void (*relocate)( void *from, void *to );
+			void (*destroy)( void *p );
+		};
+
+		constexpr std::size_t any_size = 16, any_align = alignof(std::max_align_t);
+
+		// kept in place: every arithmetic type, and anything as small that
+		// moves without throwing
+		template<typename T>
+		using any_in_place = std::integral_constant< bool,
+			sizeof(T) <= any_size && alignof(T) <= any_align &&
+			std::is_nothrow_move_constructible<T>::value >;
+
+		template<typename T, bool InPlace = any_in_place<T>::value>
+		struct any_ops_of
+		{
+			static const T &get( const void *p ) noexcept
+			{ return *static_cast<const T *>( p ); }
+			static void copy( const void *from, void *to )
+			{ ::new(to) T( get( from ) ); }
+			static void relocate( void *from, void *to )
+			{
+				T &x = *static_cast<T *>( from );
+				::new(to) T( std::move(x) );
+				x.~T();
+			}
+			static void destroy( void *p )
+			{ static_cast<T *>( p )->~T(); }
+
+			static constexpr any_ops ops{ std::is_trivially_copyable<T>::value,
+				copy, relocate, destroy };
+		};
+		template<typename T, bool InPlace>
+		constexpr any_ops any_ops_of<T, InPlace>::ops;
+
+		// elsewhere: a pointer to it kept in place
+		template<typename T>
+		struct any_ops_of<T, false>
+		{
+			static const T &get( const void *p ) noexcept
+			{ return **static_cast<T *const *>( p ); }
+			static void copy( const void *from, void *to )
+			{ ::new(to) T *( new T( get( from ) ) ); }
+			static void relocate( void *from, void *to )
+			{ std::memcpy( to, from, sizeof(T *) ); }
+			static void destroy( void *p )
+			{ delete *static_cast<T **>( p ); }
+
+			static constexpr any_ops ops{ false, copy, relocate, destroy };
+		};
+		template<typename T>
+		constexpr any_ops any_ops_of<T, false>::ops;
+	}
+
+
+	//   A quantity with its data type and unit erased: a count of any type
+	// along with its dyn_unit, in 64 bytes or so. Counts of arithmetic types
+	// are never allocated for. Back to static quantities it goes with
+	// to<T>( unit ), which throws bad_any_quantity_cast if T isn't the
+	// count's type and dimension_error if the unit is of another dimension,
+	// and otherwise rescales the count like quantity::to would, only by the
+	// ratio of the scales worked out at run time (none of it when they're
+	// the same).
+	class any_quantity
+	{
+		alignas(impl::any_align) unsigned char buffer[impl::any_size];
+		const impl::any_ops *ops = nullptr;
+		dyn_unit u;
+
+		template<typename T>
+		void emplace( T &&count )
+		{
+			using D = std::decay_t<T>;
+			emplace( std::forward<T>(count), impl::any_in_place<D>{} );
+			ops = &impl::any_ops_of<D>::ops;
+		}
+		template<typename T>
+		void emplace( T &&count, std::true_type /*in place*/ )
+		{ ::new(buffer) std::decay_t<T>( std::forward<T>(count) ); }
+		template<typename T>
+		void emplace( T &&count, std::false_type )
+		{ ::new(buffer) std::decay_t<T> *( new std::decay_t<T>( std::forward<T>(count) ) ); }
+		void take( any_quantity &other ) noexcept
+		{
+			if ( other.ops )
+			{
+				if ( other.ops->trivial )
+					std::memcpy( buffer, other.buffer, impl::any_size );
+				else
+					other.ops->relocate( other.buffer, buffer );
+			}
+			ops = std::exchange( other.ops, nullptr );
+			u = std::exchange( other.u, dyn_unit{} );
+		}
+
+	public:
+		any_quantity() noexcept = default;
+
+		template<typename T, typename Dim, typename Scale>
+		any_quantity( quantity<T, dimensional::unit<Dim, Scale>> q )
+			: u( impl::dyn_of<Dim>(), rational{ Scale{} } )
+		{ emplace( std::move(q).count() ); }
+
+		// a count in a unit made at run time, by parse_unit, say
+		template<typename T>
+		any_quantity( T count, const dyn_unit &u ) : u(u)
+		{ emplace( std::move(count) ); }
+
+		any_quantity( const any_quantity &other ) : u(other.u)
+		{
+			if ( other.ops )
+			{
+				if ( other.ops->trivial )
+					std::memcpy( buffer, other.buffer, impl::any_size );
+				else
+					other.ops->copy( other.buffer, buffer );
+			}
+			ops = other.ops;
+		}
+		any_quantity( any_quantity &&other ) noexcept
+		{ take( other ); }
+		any_quantity &operator=( any_quantity other ) noexcept
+		{
+			reset();
+			take( other );
+			return *this;
+		}
+		~any_quantity()
+		{ reset(); }
+
+		void reset() noexcept
+		{
+			if ( ops && !ops->trivial )
+				ops->destroy( buffer );
+			ops = nullptr;
+			u = dyn_unit{};
+		}
+		friend void swap( any_quantity &a, any_quantity &b ) noexcept
+		{
+			any_quantity t{ std::move(a) };
+			a.take( b );
+			b.take( t );
+		}
+
+		bool has_value() const noexcept { return ops != nullptr; }
+		const dyn_unit &unit() const noexcept { return u; }
+		const dyn_dimension &dimension() const noexcept { return u.dimension; }
+
+		template<typename T>
+		bool holds() const noexcept
+		{ return ops == &impl::any_ops_of<T>::ops; }
+
+		template<typename T>
+		const T &count() const
+		{
+			if ( !holds<T>() )
+				throw bad_any_quantity_cast{};
+			return impl::any_ops_of<T>::get( buffer );
+		}
+
+		template<typename T, typename Dim, typename Scale, typename Mode = rounding::toward_zero>
+		quantity<T, dimensional::unit<Dim, Scale>> to( dimensional::unit<Dim, Scale>, Mode mode = {} ) const
+		{
+			const T &c = count<T>();
+			if ( u.dimension != impl::dyn_of<Dim>() )
+				throw dimension_error{ "any_quantity isn't of the dimension asked for" };
+			const rational scale{ Scale{} };
+			if ( u.scale == scale )
+				return quantity<T, dimensional::unit<Dim, Scale>>{ c };
+			return quantity<T, dimensional::unit<Dim, Scale>>{ T( impl::scale_count_by(
+				c, u.scale / scale, impl::scale_tag<T>{}, mode ) ) };
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,496 @@
+// contiguous storage of quantities: raw values in one buffer, one unit for all
+
+#ifndef DIMENSIONAL_BULK_H
+#define DIMENSIONAL_BULK_H
+
+#include "dimensional.hpp"
+#include "impl/simd.hpp"
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dimensional
+{
+	template<typename T, typename Unit>
+	class quantity_span;
+	template<typename T, typename Unit, typename Allocator = std::allocator<T>>
+	class quantity_vector;
+	template<typename Node>
+	class quantity_expression;
+
+
+	namespace impl
+	{
+		// factor from one scale to another, as applied by quantity::to
+		template<typename ScaleFrom, typename ScaleTo>
+		struct rescale
+		{
+			using ratio = decltype( ScaleFrom{} / ScaleTo{} );
+			using num = decltype( ratio::num );
+			using den = decltype( ratio::den );
+			static constexpr bool identity = ratio::num == 1 && ratio::den == 1;
+		};
+
+		// out[i] = quantity<TOut,UnitTo>{ quantity<TIn,UnitFrom>{in[i]} }.count()
+		template<typename ScaleFrom, typename ScaleTo, typename TIn, typename TOut>
+		inline void convert_raw( const TIn *in, std::size_t n, TOut *out,
+			std::size_t done = 0 )
+		{
+			using r = rescale<ScaleFrom, ScaleTo>;
+			if ( r::identity )
+			{
+				for ( std::size_t i = done; i < n; ++i )
+					out[i] = TOut( in[i] );
+				return;
+			}
+			for ( std::size_t i = done; i < n; ++i )
+				out[i] = TOut( TIn( scale_count< r::num::value, r::den::value >( in[i] ) ) );
+		}
+		// the same, vectorized where there's a kernel for it
+		template<typename ScaleFrom, typename ScaleTo, typename T>
+		inline void convert_raw( const T *in, std::size_t n, T *out,
+			simd::isa with = simd::level() )
+		{
+			using r = rescale<ScaleFrom, ScaleTo>;
+			const std::size_t done = r::identity ? 0 :
+				simd::rescale_with< r::num::value, r::den::value >( with, in, n, out );
+			convert_raw<ScaleFrom, ScaleTo, T, T>( in, n, out, done );
+		}
+	}
+
+
+	// proxy for a single mutable element of a quantity_span/quantity_vector
+	template<typename T, typename Unit>
+	class quantity_reference
+	{
+		T *p;
+
+	public:
+		using value_type = quantity<T, Unit>;
+
+		explicit constexpr quantity_reference( T *p ) : p(p) {}
+		constexpr quantity_reference( const quantity_reference & ) = default;
+
+		constexpr operator value_type() const { return value_type{ *p }; }
+		constexpr value_type get() const { return *this; }
+		constexpr T &count() const { return *p; }
+
+		const quantity_reference &operator=( const value_type &q ) const
+		{
+			*p = q.count();
+			return *this;
+		}
+		const quantity_reference &operator=( const quantity_reference &r ) const
+		{
+			return *this = r.get();
+		}
+		template<typename TR, typename UnitR>
+		const quantity_reference &operator=( const quantity<TR, UnitR> &q ) const
+		{
+			return *this = value_type{ q };
+		}
+		template<typename TR, typename UnitR>
+		const quantity_reference &operator+=( const quantity<TR, UnitR> &q ) const
+		{
+			return *this = get() + q;
+		}
+		template<typename TR, typename UnitR>
+		const quantity_reference &operator-=( const quantity<TR, UnitR> &q ) const
+		{
+			return *this = get() - q;
+		}
+
+		friend void swap( quantity_reference a, quantity_reference b )
+		{
+			using std::swap;
+			swap( *a.p, *b.p );
+		}
+	};
+
+	namespace impl
+	{
+		template<typename T, typename Unit>
+		struct element
+		{
+			using reference = quantity_reference<T, Unit>;
+			static constexpr reference get( T *p ) { return reference{ p }; }
+		};
+		template<typename T, typename Unit>
+		struct element<const T, Unit>
+		{
+			using reference = quantity<T, Unit>;
+			static constexpr reference get( const T *p ) { return reference{ *p }; }
+		};
+	}
+
+	// random access iterator over raw values, dereferencing to quantities
+	template<typename T, typename Unit>
+	class quantity_iterator
+	{
+		T *p = nullptr;
+
+		using element = impl::element<T, Unit>;
+
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type        = quantity< std::remove_const_t<T>, Unit >;
+		using difference_type   = std::ptrdiff_t;
+		using reference         = typename element::reference;
+		using pointer           = void;
+
+		constexpr quantity_iterator() = default;
+		explicit constexpr quantity_iterator( T *p ) : p(p) {}
+		// iterator -> const_iterator
+		template<typename U, typename = std::enable_if_t<
+			std::is_same<const U, T>::value && !std::is_same<U, T>::value >>
+		constexpr quantity_iterator( const quantity_iterator<U, Unit> &it )
+			: p(it.base()) {}
+
+		constexpr T *base() const { return p; }
+
+		constexpr reference operator*() const { return element::get( p ); }
+		constexpr reference operator[]( difference_type i ) const
+		{ return element::get( p+i ); }
+
+		quantity_iterator &operator++() { ++p; return *this; }
+		quantity_iterator &operator--() { --p; return *this; }
+		quantity_iterator operator++( int ) { return quantity_iterator{ p++ }; }
+		quantity_iterator operator--( int ) { return quantity_iterator{ p-- }; }
+		quantity_iterator &operator+=( difference_type i ) { p += i; return *this; }
+		quantity_iterator &operator-=( difference_type i ) { p -= i; return *this; }
+
+		friend constexpr quantity_iterator operator+( quantity_iterator it, difference_type i )
+		{ return quantity_iterator{ it.p + i }; }
+		friend constexpr quantity_iterator operator+( difference_type i, quantity_iterator it )
+		{ return quantity_iterator{ it.p + i }; }
+		friend constexpr quantity_iterator operator-( quantity_iterator it, difference_type i )
+		{ return quantity_iterator{ it.p - i }; }
+		friend constexpr difference_type operator-( quantity_iterator a, quantity_iterator b )
+		{ return a.p - b.p; }
+
+		friend constexpr bool operator==( quantity_iterator a, quantity_iterator b )
+		{ return a.p == b.p; }
+		friend constexpr bool operator!=( quantity_iterator a, quantity_iterator b )
+		{ return a.p != b.p; }
+		friend constexpr bool operator< ( quantity_iterator a, quantity_iterator b )
+		{ return a.p <  b.p; }
+		friend constexpr bool operator> ( quantity_iterator a, quantity_iterator b )
+		{ return a.p >  b.p; }
+		friend constexpr bool operator<=( quantity_iterator a, quantity_iterator b )
+		{ return a.p <= b.p; }
+		friend constexpr bool operator>=( quantity_iterator a, quantity_iterator b )
+		{ return a.p >= b.p; }
+	};
+
+
+	// non-owning view of contiguous raw values of the given unit
+	// T may be const-qualified for a read-only view
+	template<typename T, typename Dim, typename Scale>
+	class quantity_span< T, unit<Dim, Scale> >
+	{
+		T *ptr = nullptr;
+		std::size_t len = 0;
+
+		using unit_type = dimensional::unit<Dim, Scale>;
+
+	public:
+		using element_type   = T;
+		using value_type     = quantity< std::remove_const_t<T>, unit_type >;
+		using size_type      = std::size_t;
+		using iterator       = quantity_iterator< T, unit_type >;
+		using reference      = typename iterator::reference;
+
+		constexpr quantity_span() = default;
+		constexpr quantity_span( T *data, std::size_t size ) : ptr(data), len(size) {}
+		// span -> const span
+		template<typename U, typename = std::enable_if_t<
+			std::is_same<const U, T>::value && !std::is_same<U, T>::value >>
+		constexpr quantity_span( const quantity_span<U, unit_type> &s )
+			: ptr(s.data()), len(s.size()) {}
+		template<typename U, typename Alloc, typename = std::enable_if_t<
+			std::is_same<std::remove_const_t<T>, U>::value >>
+		quantity_span( quantity_vector<U, unit_type, Alloc> &v )
+			: ptr(v.data()), len(v.size()) {}
+		template<typename U, typename Alloc, typename = std::enable_if_t<
+			std::is_same<T, const U>::value >>
+		quantity_span( const quantity_vector<U, unit_type, Alloc> &v )
+			: ptr(v.data()), len(v.size()) {}
+
+		constexpr T *data() const { return ptr; }
+		constexpr std::size_t size() const { return len; }
+		constexpr bool empty() const { return len == 0; }
+
+		constexpr reference operator[]( std::size_t i ) const { return begin()[i]; }
+		constexpr reference front() const { return *begin(); }
+		constexpr reference back()  const { return begin()[len-1]; }
+
+		constexpr iterator begin() const { return iterator{ ptr }; }
+		constexpr iterator end()   const { return iterator{ ptr + len }; }
+
+		constexpr quantity_span subspan( std::size_t offset, std::size_t count ) const
+		{ return { ptr + offset, count }; }
+		constexpr quantity_span first( std::size_t count ) const { return { ptr, count }; }
+		constexpr quantity_span last ( std::size_t count ) const
+		{ return { ptr + len - count, count }; }
+
+		static constexpr unit_type unit{};
+		static constexpr auto dimension = unit.dimension;
+		static constexpr auto scale = unit.scale;
+	};
+
+
+	//   Buffers already in memory, viewed as quantities in place: raw counts
+	// of unit u, or arrays of quantities themselves (e.g. a std::vector of
+	// them, for the bulk operations). Nothing is copied; a scale other than
+	// the one wanted is left to the operations on the view, which convert
+	// on the fly, or to one pass of convert().
+	template<typename T, typename Dim, typename Scale>
+	inline constexpr auto as_quantities( T *data, std::size_t size, unit<Dim, Scale> )
+	{ return quantity_span< T, unit<Dim, Scale> >{ data, size }; }
+	template<typename T, typename Unit>
+	inline auto as_quantities( quantity<T, Unit> *data, std::size_t size )
+	{ return quantity_span<T, Unit>{ impl::counts_in<T>( data ), size }; }
+	template<typename T, typename Unit>
+	inline auto as_quantities( const quantity<T, Unit> *data, std::size_t size )
+	{ return quantity_span<const T, Unit>{ impl::counts_in<const T>( data ), size }; }
+
+
+	// dst[i] = src[i], converted to the unit and type of dst, for all i
+	// the sizes must match; src and dst may be the same buffer
+	template<typename TIn, typename UnitIn, typename TOut, typename UnitOut>
+	inline void convert( quantity_span<TIn, UnitIn> src, quantity_span<TOut, UnitOut> dst )
+	{
+		static_assert( src.dimension == dst.dimension,
+			"converting between quantities with different dimension" );
+		assert( src.size() == dst.size() );
+		impl::convert_raw< std::decay_t<decltype(src.scale)>, std::decay_t<decltype(dst.scale)> >(
+			src.data(), src.size(), dst.data() );
+	}
+
+
+	namespace impl
+	{
+		// out[i] = heterop_raw( op, a[i], b[i] ), vectorized where possible
+		template<typename ScaleA, typename ScaleB, typename Op, typename TA, typename TB, typename R>
+		inline void heterop_n( Op op, const TA *a, const TB *b, std::size_t n, R *out,
+			simd::isa with = simd::level() )
+		{
+			using common  = common_scale<ScaleA, ScaleB>;
+			using a_scale = typename common::a_scale;
+			using b_scale = typename common::b_scale;
+			using policy_a = typename overflow_policy<TA>::type;
+			using policy_b = typename overflow_policy<TB>::type;
+			// the kernels don't check
+			const bool unchecked =
+				std::is_same<policy_a, overflow::unchecked>::value &&
+				std::is_same<policy_b, overflow::unchecked>::value;
+			std::size_t i = !unchecked ? 0 :
+				simd::heterop_with< a_scale::value, b_scale::value >( with, op, a, b, n, out );
+			for ( ; i < n; ++i )
+				out[i] = op(
+					scale_operand( policy_a{}, a[i], a_scale{} ),
+					scale_operand( policy_b{}, b[i], b_scale{} ) );
+		}
+
+		// the type of an operand once brought to a common scale
+		template<typename T>
+		using scaled_operand = decltype( scale_operand(
+			typename overflow_policy<T>::type{}, std::declval<T>(), c<1>{} ) );
+
+		template<typename Op, typename SpanA, typename SpanB>
+		using heterop_result = decltype( std::declval<Op>()(
+			std::declval<scaled_operand<std::remove_const_t<typename SpanA::element_type>>>(),
+			std::declval<scaled_operand<std::remove_const_t<typename SpanB::element_type>>>() ) );
+
+		template<typename Op, typename TA, typename UnitA, typename TB, typename UnitB,
+			typename TOut, typename UnitOut>
+		inline void heterop_spans( Op op,
+			quantity_span<TA, UnitA> a, quantity_span<TB, UnitB> b,
+			quantity_span<TOut, UnitOut> out )
+		{
+			static_assert( a.dimension == b.dimension,
+				"operating on quantities with different dimensions" );
+			static_assert( out.unit == common_unit<UnitA, UnitB>{},
+				"output not in the common unit of the operands" );
+			static_assert( std::is_same< TOut,
+				heterop_result<Op, decltype(a), decltype(b)> >::value,
+				"output not of the type of the results" );
+			assert( a.size() == b.size() && a.size() == out.size() );
+			heterop_n< std::decay_t<decltype(a.scale)>, std::decay_t<decltype(b.scale)> >(
+				op, a.data(), b.data(), a.size(), out.data() );
+		}
+
+		template<typename Op, typename TA, typename UnitA, typename TB, typename UnitB>
+		inline void heterop_spans( Op op,
+			quantity_span<TA, UnitA> a, quantity_span<TB, UnitB> b, bool *out )
+		{
+			static_assert( a.dimension == b.dimension,
+				"operating on quantities with different dimensions" );
+			assert( a.size() == b.size() );
+			heterop_n< std::decay_t<decltype(a.scale)>, std::decay_t<decltype(b.scale)> >(
+				op, a.data(), b.data(), a.size(), out );
+		}
+
+		template<typename Op, typename SpanA, typename SpanB>
+		inline auto heterop_vector( Op op, SpanA a, SpanB b )
+		{
+			quantity_vector< heterop_result<Op, SpanA, SpanB>,
+				common_unit< std::decay_t<decltype(a.unit)>, std::decay_t<decltype(b.unit)> > >
+				res( a.size() );
+			heterop_spans( op, a, b, res.view() );
+			return res;
+		}
+	}
+
+	// out[i] = a[i] + b[i], for all i
+	// out is in the common unit of a and b, as with quant + quant
+	template<typename TA, typename UnitA, typename TB, typename UnitB, typename TOut, typename UnitOut>
+	inline void add( quantity_span<TA, UnitA> a, quantity_span<TB, UnitB> b,
+		quantity_span<TOut, UnitOut> out )
+	{ impl::heterop_spans( mjk::plus, a, b, out ); }
+	template<typename TA, typename UnitA, typename TB, typename UnitB>
+	inline auto add( quantity_span<TA, UnitA> a, quantity_span<TB, UnitB> b )
+	{ return impl::heterop_vector( mjk::plus, a, b ); }
+
+	// out[i] = a[i] - b[i], for all i
+	template<typename TA, typename UnitA, typename TB, typename UnitB, typename TOut, typename UnitOut>
+	inline void subtract( quantity_span<TA, UnitA> a, quantity_span<TB, UnitB> b,
+		quantity_span<TOut, UnitOut> out )
+	{ impl::heterop_spans( mjk::minus, a, b, out ); }
+	template<typename TA, typename UnitA, typename TB, typename UnitB>
+	inline auto subtract( quantity_span<TA, UnitA> a, quantity_span<TB, UnitB> b )
+	{ return impl::heterop_vector( mjk::minus, a, b ); }
+
+	// mask[i] = a[i] < b[i], for all i
+	template<typename TA, typename UnitA, typename TB, typename UnitB>
+	inline void less( quantity_span<TA, UnitA> a, quantity_span<TB, UnitB> b, bool *mask )
+	{ impl::heterop_spans( mjk::less, a, b, mask ); }
+
+	// mask[i] = a[i] == b[i], for all i
+	template<typename TA, typename UnitA, typename TB, typename UnitB>
+	inline void equal( quantity_span<TA, UnitA> a, quantity_span<TB, UnitB> b, bool *mask )
+	{ impl::heterop_spans( mjk::equal_to, a, b, mask ); }
+
+
+	// contiguous container of raw values of the given unit
+	// data() is a plain T* for kernels; elements are read as quantities
+	template<typename T, typename Dim, typename Scale, typename Allocator>
+	class quantity_vector< T, unit<Dim, Scale>, Allocator >
+	{
+		using unit_type = dimensional::unit<Dim, Scale>;
+
+		std::vector<T, Allocator> vals;
+
+	public:
+		using value_type      = quantity<T, unit_type>;
+		using allocator_type  = Allocator;
+		using size_type       = std::size_t;
+		using iterator        = quantity_iterator<T, unit_type>;
+		using const_iterator  = quantity_iterator<const T, unit_type>;
+		using reference       = typename iterator::reference;
+		using const_reference = typename const_iterator::reference;
+		using span            = quantity_span<T, unit_type>;
+		using const_span      = quantity_span<const T, unit_type>;
+
+		quantity_vector() = default;
+		explicit quantity_vector( const Allocator &a ) : vals(a) {}
+		explicit quantity_vector( std::size_t n, const Allocator &a = {} ) : vals(n, a) {}
+		quantity_vector( std::size_t n, const value_type &q, const Allocator &a = {} )
+			: vals(n, q.count(), a) {}
+		quantity_vector( std::initializer_list<value_type> qs, const Allocator &a = {} )
+			: vals(a)
+		{
+			vals.reserve( qs.size() );
+			for ( const auto &q : qs )
+				vals.push_back( q.count() );
+		}
+		// adopts raw values, taken to be in this unit
+		explicit quantity_vector( std::vector<T, Allocator> raw )
+			: vals(std::move(raw)) {}
+
+		// converts in a single pass over the raw values
+		template<typename TR, typename DimR, typename ScaleR>
+		explicit quantity_vector( quantity_span<TR, dimensional::unit<DimR, ScaleR>> s,
+			const Allocator &a = {} )
+			: vals(s.size(), a)
+		{
+			static_assert( s.dimension == dimension,
+				"converting from quantities with different dimension" );
+			impl::convert_raw<ScaleR, Scale>( s.data(), s.size(), vals.data() );
+		}
+		template<typename TR, typename DimR, typename ScaleR, typename AllocR>
+		explicit quantity_vector(
+			const quantity_vector<TR, dimensional::unit<DimR, ScaleR>, AllocR> &v,
+			const Allocator &a = {} )
+			: quantity_vector( v.cspan(), a )
+		{}
+
+		// evaluates element-wise arithmetic (see expression.hpp) in one pass
+		template<typename Node>
+		explicit quantity_vector( const quantity_expression<Node> &e, const Allocator &a = {} )
+			: vals(e.size(), a)
+		{ assign( view(), e ); }
+		template<typename Node>
+		quantity_vector &operator=( const quantity_expression<Node> &e )
+		{
+			// in place when the size is right, as e may refer to *this
+			if ( e.size() == size() )
+				assign( view(), e );
+			else
+				*this = quantity_vector( e, get_allocator() );
+			return *this;
+		}
+
+		T *data() { return vals.data(); }
+		const T *data() const { return vals.data(); }
+		std::size_t size() const { return vals.size(); }
+		std::size_t capacity() const { return vals.capacity(); }
+		bool empty() const { return vals.empty(); }
+		allocator_type get_allocator() const { return vals.get_allocator(); }
+
+		// the raw values, e.g. to move them out
+		std::vector<T, Allocator> &raw() & { return vals; }
+		const std::vector<T, Allocator> &raw() const & { return vals; }
+		std::vector<T, Allocator> raw() && { return std::move(vals); }
+
+		span       view()        { return { data(), size() }; }
+		const_span view()  const { return { data(), size() }; }
+		const_span cspan() const { return view(); }
+
+		reference       operator[]( std::size_t i )       { return begin()[i]; }
+		const_reference operator[]( std::size_t i ) const { return begin()[i]; }
+		reference       front()       { return *begin(); }
+		const_reference front() const { return *begin(); }
+		reference       back()        { return begin()[size()-1]; }
+		const_reference back()  const { return begin()[size()-1]; }
+
+		iterator       begin()        { return iterator{ data() }; }
+		iterator       end()          { return iterator{ data() + size() }; }
+		const_iterator begin()  const { return const_iterator{ data() }; }
+		const_iterator end()    const { return const_iterator{ data() + size() }; }
+		const_iterator cbegin() const { return begin(); }
+		const_iterator cend()   const { return end(); }
+
+		void reserve( std::size_t n ) { vals.reserve( n ); }
+		void resize( std::size_t n ) { vals.resize( n ); }
+		void resize( std::size_t n, const value_type &q ) { vals.resize( n, q.count() ); }
+		void clear() { vals.clear(); }
+		void shrink_to_fit() { vals.shrink_to_fit(); }
+
+		void push_back( const value_type &q ) { vals.push_back( q.count() ); }
+		template<typename TR, typename UnitR>
+		void push_back( const quantity<TR, UnitR> &q ) { push_back( value_type{ q } ); }
+		void pop_back() { vals.pop_back(); }
+
+		static constexpr unit_type unit{};
+		static constexpr auto dimension = unit.dimension;
+		static constexpr auto scale = unit.scale;
+	};
+}
+
+#endif
@@ -7,6 +7,12 @@
 #include "impl/meta.hpp"
 #include "impl/rational_constant.hpp"
 #include "impl/mjk/conv"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace dimensional
 {
@@ -15,6 +21,36 @@ namespace dimensional
 	namespace constant_literals = meta::rational_constant_literals;
 
 
+	// compile-time ordering key of a dimension tag
+	// to be user-specialized, should the default keys of two tags collide
+	// (e.g. identically named local structs in the same scope)
+	template<typename Tag>
+	struct dimension_key;
+
+	namespace impl
+	{
+		// FNV-1a of the compiler's pretty name of T
+		template<typename T>
+		inline constexpr std::uint64_t type_name_hash()
+		{
+		#ifdef _MSC_VER
+			const char *name = __FUNCSIG__;
+		#else
+			const char *name = __PRETTY_FUNCTION__;
+		#endif
+			std::uint64_t hash = 14695981039346656037u;
+			for ( ; *name; ++name )
+				hash = (hash ^ static_cast<unsigned char>(*name)) * 1099511628211u;
+			return hash;
+		}
+	}
+
+	template<typename Tag>
+	struct dimension_key
+		: mjk::integral_constant< std::uint64_t, impl::type_name_hash<Tag>() >
+	{};
+
+
 	// represents a single fundamental physical dimension, exponentiated
 	// e.g. time; length squared
 	template<typename Tag, typename Power>
@@ -23,10 +59,27 @@ namespace dimensional
 		using tag_type = Tag;
 		static constexpr meta::type<Tag> tag{};
 		static constexpr Power power{};
+		static constexpr std::uint64_t key = dimension_key<Tag>::value;
 	};
 
+	namespace impl
+	{
+		inline constexpr bool is_ordered() { return true; }
+		template<typename... Keys>
+		inline constexpr bool is_ordered( std::uint64_t first, Keys... other )
+		{
+			const std::uint64_t keys[] = { first, other... };
+			for ( std::size_t i = 1; i < sizeof...(other)+1; ++i )
+				if ( !(keys[i-1] < keys[i]) )
+					return false;
+			return true;
+		}
+	}
+
 	// represents a product of multiple exponentiated dimensions
 	// e.g. mass¹ × length¹ × time⁻²
+	// factors are kept sorted by the keys of their tags, so that every
+	// dimension has exactly one representation
 	template<typename FactorSet>
 	struct dimension_product
 	{
@@ -37,7 +90,11 @@ namespace dimensional
 	template<typename... Tags, typename... Powers>
 	struct dimension_product< meta::set< dimension_factor<Tags,Powers>... > >
 	{
+		static_assert( impl::is_ordered( dimension_key<Tags>::value... ),
+			"'dimension_product' factors must be ordered by 'dimension_key'. "
+			"build dimensions with operators instead of spelling them" );
 		static constexpr auto factors = meta::set< dimension_factor<Tags,Powers>... >{};
+		using canonical_type = dimension_product;
 	};
 
 	// makes a dimension_product for a single dimension
@@ -46,6 +103,16 @@ namespace dimensional
 
 	constexpr auto dimensionless = dimension_product< meta::set<> >{};
 
+	// short name of a canonical dimension_product, to appear in place of its
+	// full spelling in units, quantities, symbols and diagnostics
+	// to be user-specialized with a class derived from Dimension, before any
+	// operation yields that dimension, and consistently across all TUs
+	template<typename Dimension>
+	struct dimension_name
+	{
+		using type = Dimension;
+	};
+
 	namespace impl
 	{
 		template<typename DimA, typename DimB>
@@ -64,31 +131,124 @@ namespace dimensional
 		template< typename Set >
 		using remove_ones = meta::uset::remove_if< Set, is_one >;
 
-		template< typename SetA, typename SetB >
-		struct multiply;
+		// -1, 0 or +1 as DimA's tag goes before, together with or after DimB's
+		template<typename DimA, typename DimB>
+		struct order : std::integral_constant< int,
+			DimA::key < DimB::key ? -1 : DimB::key < DimA::key ? +1 : 0 >
+		{
+			static_assert( DimA::key != DimB::key || is_related<DimA,DimB>::value,
+				"ordering keys of two different dimension tags collide. "
+				"specialize 'dimensional::dimension_key' for one of them" );
+		};
+
+		// single-pass merge of two ordered factor sets
+		template< typename Out, typename SetA, typename SetB >
+		struct merge;
+
+		template< int Order, typename Out, typename SetA, typename SetB >
+		struct merge_step;
+
+		template< typename... Out, typename... FactorsB >
+		struct merge< meta::set<Out...>, meta::set<>, meta::set<FactorsB...> >
+		{
+			using type = meta::set< Out..., FactorsB... >;
+		};
+
+		template< typename... Out, typename HeadA, typename... TailA >
+		struct merge< meta::set<Out...>, meta::set<HeadA,TailA...>, meta::set<> >
+		{
+			using type = meta::set< Out..., HeadA, TailA... >;
+		};
+
+		template<
+			typename... Out,
+			typename HeadA, typename... TailA,
+			typename HeadB, typename... TailB
+		>
+		struct merge<
+			meta::set<Out...>,
+			meta::set<HeadA,TailA...>,
+			meta::set<HeadB,TailB...> >
+			: merge_step< order<HeadA,HeadB>::value,
+				meta::set<Out...>,
+				meta::set<HeadA,TailA...>,
+				meta::set<HeadB,TailB...> >
+		{};
+
+		template<
+			typename... Out,
+			typename HeadA, typename... TailA,
+			typename HeadB, typename... TailB
+		>
+		struct merge_step< -1,
+			meta::set<Out...>,
+			meta::set<HeadA,TailA...>,
+			meta::set<HeadB,TailB...> >
+			: merge< meta::set<Out...,HeadA>,
+				meta::set<TailA...>,
+				meta::set<HeadB,TailB...> >
+		{};
 
 		template<
-			template<typename...> class Set,
-			typename... FactorsA,
-			typename FactorsB_Head, typename... FactorsB_Tail
+			typename... Out,
+			typename HeadA, typename... TailA,
+			typename HeadB, typename... TailB
 		>
-		struct multiply< Set<FactorsA...>, Set<FactorsB_Head,FactorsB_Tail...> >
+		struct merge_step< +1,
+			meta::set<Out...>,
+			meta::set<HeadA,TailA...>,
+			meta::set<HeadB,TailB...> >
+			: merge< meta::set<Out...,HeadB>,
+				meta::set<HeadA,TailA...>,
+				meta::set<TailB...> >
+		{};
+
+		template<
+			typename... Out,
+			typename HeadA, typename... TailA,
+			typename HeadB, typename... TailB
+		>
+		struct merge_step< 0,
+			meta::set<Out...>,
+			meta::set<HeadA,TailA...>,
+			meta::set<HeadB,TailB...> >
 		{
 		private:
-			using tailprod = typename multiply< Set<FactorsA...>, Set<FactorsB_Tail...> >::type;
-			using multiplied = meta::uset::insert< tailprod, FactorsB_Head, is_related, mul >;
+			using product = typename mul<HeadA,HeadB>::type;
+			using out = std::conditional_t< is_one<product>::value,
+				meta::set<Out...>,
+				meta::set<Out...,product> >;
 		public:
-			using type = remove_ones< multiplied >;
+			using type = typename merge< out,
+				meta::set<TailA...>,
+				meta::set<TailB...> >::type;
 		};
 
-		template<
-			template<typename...> class Set,
-			typename... FactorsA
-		>
-		struct multiply< Set<FactorsA...>, Set<> >
+		template< typename SetA, typename SetB >
+		struct multiply : merge< meta::set<>, SetA, SetB > {};
+
+		template< typename... Sets >
+		struct multiply_all;
+		template< typename Set >
+		struct multiply_all<Set> : meta::identity<Set> {};
+		template< typename SetA, typename SetB, typename... Rest >
+		struct multiply_all< SetA, SetB, Rest... >
+			: multiply_all< typename multiply<SetA,SetB>::type, Rest... > {};
+
+		template<typename Dim>
+		struct named
 		{
-			using type = Set<FactorsA...>;
+			using type = typename dimension_name<Dim>::type;
+			static_assert( std::is_base_of< Dim, type >::value,
+				"'dimension_name' must be derived from the dimension it names" );
 		};
+		template<typename Dim>
+		using named_t = typename named<Dim>::type;
+
+		template<typename Factors>
+		meta::true_type is_dimension( const dimension_product<Factors> * );
+		meta::false_type is_dimension( const void * );
+		// ^ for use in unevaluated contexts only
 
 		template<typename Pow>
 		struct pow
@@ -101,35 +261,42 @@ namespace dimensional
 		};
 	}
 
+	// canonical (never named) product of dimension_factors, in any order
+	// for spelling dimensions in dimension_name specializations
+	template<typename... Factors>
+	using canonical_dimension = dimension_product< impl::remove_ones<
+		typename impl::multiply_all< meta::set<>, meta::set<Factors>... >::type > >;
+
 	// dimen * dimen
 	template<typename FactorsA, typename FactorsB>
-	inline constexpr auto operator*( dimension_product<FactorsA>, dimension_product<FactorsB> )
-	{ return dimension_product< typename impl::multiply<FactorsA,FactorsB>::type >{}; }
+	inline constexpr auto operator*( dimension_product<FactorsA>, dimension_product<FactorsB> ) noexcept
+	{ return impl::named_t< dimension_product<
+		typename impl::multiply<FactorsA,FactorsB>::type > >{}; }
 
 	// dimen ^ const
 	template<typename FactorsA, intmax_t Num, intmax_t Denom>
-	inline constexpr auto operator^( dimension_product<FactorsA>, constant<Num,Denom> pow )
-	{ return []{}, dimension_product< impl::remove_ones<
-		meta::uset::transform<FactorsA, impl::pow<decltype(pow)>::template f> > >{}; }
+	inline constexpr auto operator^( dimension_product<FactorsA>, constant<Num,Denom> pow ) noexcept
+	{ return impl::named_t< dimension_product< impl::remove_ones<
+		meta::uset::transform<FactorsA, impl::pow<decltype(pow)>::template f> > > >{}; }
 
 	// dimen / dimen
 	template<typename FactorsA, typename FactorsB>
-	inline constexpr auto operator/( dimension_product<FactorsA> a, dimension_product<FactorsB> b )
+	inline constexpr auto operator/( dimension_product<FactorsA> a, dimension_product<FactorsB> b ) noexcept
 	{ return a * (b^constant<-1>{}); }
 
 	// dimen == dimen
 	template<typename FactorsA, typename FactorsB>
-	inline constexpr auto operator==( dimension_product<FactorsA>, dimension_product<FactorsB> )
-	{ return meta::uset::equal<FactorsA,FactorsB>{}; }
+	inline constexpr auto operator==( dimension_product<FactorsA>, dimension_product<FactorsB> ) noexcept
+	{ return meta::bool_constant< meta::is_same<FactorsA,FactorsB>::value >{}; }
 	// dimen != dimen
 	template<typename FactorsA, typename FactorsB>
-	inline constexpr auto operator!=( dimension_product<FactorsA> a, dimension_product<FactorsB> b )
+	inline constexpr auto operator!=( dimension_product<FactorsA> a, dimension_product<FactorsB> b ) noexcept
 	{ return meta::not_( a == b ); }
 
 	// +dimen
 	template<typename Factors>
-	inline constexpr auto operator+( dimension_product<Factors> d )
-	{ return d; }
+	inline constexpr auto operator+( dimension_product<Factors> ) noexcept
+	{ return impl::named_t< dimension_product<Factors> >{}; }
 
 
 
@@ -140,90 +307,259 @@ namespace dimensional
 			"bad parameters for 'unit': "
 				"'dimension_product' and 'constant' expected" );
 	};
-	template<typename Factors, intmax_t Num, intmax_t Den>
-	struct unit< dimension_product<Factors>, constant<Num,Den> >
+	template<typename Dimension, intmax_t Num, intmax_t Den>
+	struct unit< Dimension, constant<Num,Den> >
 	{
-		static constexpr auto dimension = dimension_product<Factors>{};
+		static_assert( decltype(impl::is_dimension( (Dimension *)nullptr ))::value,
+			"bad parameters for 'unit': "
+				"'dimension_product' and 'constant' expected" );
+		static constexpr auto dimension = Dimension{};
 		static constexpr auto scale     = constant<Num,Den>{};
 	};
 
 	// dimen -> unit
 	template<typename FactorSet>
-	inline constexpr auto unit_of( dimension_product<FactorSet> d )
-	{ return unit< decltype(d), constant<1> >{}; }
+	inline constexpr auto unit_of( dimension_product<FactorSet> ) noexcept
+	{ return unit< impl::named_t< dimension_product<FactorSet> >, constant<1> >{}; }
 
 	constexpr auto unitless = unit_of( dimensionless );
 
 
 	// unit * unit
 	template<typename DimA, typename ScaleA, typename DimB, typename ScaleB>
-	inline constexpr auto operator*( unit<DimA, ScaleA>, unit<DimB, ScaleB> )
+	inline constexpr auto operator*( unit<DimA, ScaleA>, unit<DimB, ScaleB> ) noexcept
 	{ return (ScaleA{} * ScaleB{}) * unit_of(DimA{} * DimB{}); }
 
 	// unit / unit
 	template<typename DimA, typename ScaleA, typename DimB, typename ScaleB>
-	inline constexpr auto operator/( unit<DimA, ScaleA>, unit<DimB, ScaleB> )
+	inline constexpr auto operator/( unit<DimA, ScaleA>, unit<DimB, ScaleB> ) noexcept
 	{ return (ScaleA{} / ScaleB{}) * unit_of(DimA{} / DimB{}); }
 
 	// unit ^ const
 	template<typename Dim, typename Scale, intmax_t Num, intmax_t Denom>
-	inline constexpr auto operator^( unit<Dim,Scale>, constant<Num,Denom> p )
+	inline constexpr auto operator^( unit<Dim,Scale>, constant<Num,Denom> p ) noexcept
 	{ return pow(Scale{},p) * unit_of(Dim{}^p); }
 
 	// sqrt( unit )
 	template<typename Dim, typename Scale>
-	inline constexpr auto sqrt( unit<Dim,Scale> u )
+	inline constexpr auto sqrt( unit<Dim,Scale> u ) noexcept
 	{ return u ^ constant<1,2>{}; }
 
 	// unit == unit
 	template<typename DimA, typename ScaleA, typename DimB, typename ScaleB>
-	inline constexpr auto operator==( unit<DimA, ScaleA>, unit<DimB, ScaleB> )
+	inline constexpr auto operator==( unit<DimA, ScaleA>, unit<DimB, ScaleB> ) noexcept
 	{ return meta::bool_constant<DimA{} == DimB{} && ScaleA{} == ScaleB{}>{}; }
 
 	// unit != unit
 	template<typename DimA, typename ScaleA, typename DimB, typename ScaleB>
-	inline constexpr auto operator!=( unit<DimA, ScaleA> a, unit<DimB, ScaleB> b )
+	inline constexpr auto operator!=( unit<DimA, ScaleA> a, unit<DimB, ScaleB> b ) noexcept
 	{ return meta::not_( a == b ); }
 
 	// const * unit
 	template<intmax_t Num, intmax_t Den, typename Dim, typename ScaleB>
-	inline constexpr auto operator*( constant<Num,Den> scaleA, unit<Dim, ScaleB> )
+	inline constexpr auto operator*( constant<Num,Den> scaleA, unit<Dim, ScaleB> ) noexcept
 	{ return unit<Dim, decltype(scaleA*ScaleB{})>{}; }
 
 	// const / unit
 	template<intmax_t Num, intmax_t Den, typename Dim, typename ScaleB>
-	inline constexpr auto operator/( constant<Num,Den> scaleA, unit<Dim, ScaleB> b )
+	inline constexpr auto operator/( constant<Num,Den> scaleA, unit<Dim, ScaleB> b ) noexcept
 	{ return scaleA * (b^constant<-1>{}); }
 
 
+	// how integer conversions to coarser units round the quotient
+	// (e.g. quantity::to( kg, rounding::nearest{} ))
+	namespace rounding
+	{
+		// truncates, as ever
+		struct toward_zero {};
+		// to the nearest, ties away from zero, like std::round
+		struct nearest {};
+		// toward negative infinity
+		struct floor {};
+		// toward positive infinity
+		struct ceil {};
+	}
+
+	// x*Num/Den, as count()*num/den, with the powers of two in the ratio
+	// taken out at compile time: integers get them as shifts, floating point
+	// as exact power-of-two factors (the way ldexp would adjust exponents)
+	namespace impl
+	{
+		// exponent of the greatest power of two dividing n (n != 0)
+		inline constexpr int twos( intmax_t n ) noexcept
+		{
+			int k = 0;
+			for ( ; n % 2 == 0; n /= 2 )
+				++k;
+			return k;
+		}
+
+		template<typename T>
+		inline constexpr T pow2( int k ) noexcept
+		{
+			T res = 1;
+			for ( ; k > 0; --k ) res *= 2;
+			for ( ; k < 0; ++k ) res /= 2;
+			return res;
+		}
+
+		// y*2^K, wrapping around for signed I just like the product would
+		template<int K, typename I>
+		inline constexpr I shift_up( I y ) noexcept
+		{
+			using U = std::make_unsigned_t<I>;
+			return K == 0 ? y : static_cast<I>( static_cast<U>(y) << K );
+		}
+		// y/2^K, truncated
+		// (an arithmetic shift for signed I, made to round toward zero)
+		template<int K, typename I>
+		inline constexpr I shift_down( I y ) noexcept
+		{
+			return K == 0 ? y :
+				y < 0 ? static_cast<I>( (y + ((I{1} << K) - 1)) >> K ) : static_cast<I>( y >> K );
+		}
+
+		// the truncated quotient q of p/Den, rounded as per the mode instead
+		// (the compiler divides by the constant with multiply-high anyway;
+		// the remainder is then had with one more multiplication)
+		template<intmax_t Den, typename I>
+		inline constexpr bool fits() noexcept
+		{
+			return sizeof(I) > sizeof(intmax_t) ||
+				uintmax_t(Den) <= uintmax_t(std::numeric_limits<I>::max());
+		}
+		template<intmax_t Den, typename I>
+		inline constexpr bool divisible( const I &p, const I &q ) noexcept
+		{ return fits<Den, I>() ? p == q * static_cast<I>( Den ) : p == I{0}; }
+		template<intmax_t Den, typename I>
+		inline constexpr I rounded( const I &, const I &q, rounding::toward_zero ) noexcept
+		{ return q; }
+		template<intmax_t Den, typename I>
+		inline constexpr I rounded( const I &p, const I &q, rounding::floor ) noexcept
+		{ return p < I{0} && !divisible<Den>( p, q ) ? I(q - 1) : q; }
+		template<intmax_t Den, typename I>
+		inline constexpr I rounded( const I &p, const I &q, rounding::ceil ) noexcept
+		{ return p > I{0} && !divisible<Den>( p, q ) ? I(q + 1) : q; }
+		template<intmax_t Den, typename I>
+		inline constexpr I rounded( const I &p, const I &q, rounding::nearest ) noexcept
+		{
+			// |p - q*Den| against Den/2, without overflow
+			const I r = fits<Den, I>() ? I(p - q * static_cast<I>( Den )) : p;
+			const uintmax_t mag = r < I{0} ? uintmax_t{0} - uintmax_t(r) : uintmax_t(r);
+			return mag == 0 || uintmax_t(Den) - mag > mag ? q :
+				p < I{0} ? I(q - 1) : I(q + 1);
+		}
+
+		template<intmax_t Num, intmax_t Den, typename T, typename Mode>
+		inline constexpr auto scale_count( const T &x, std::true_type /*integer*/, Mode mode ) noexcept
+		{
+			using I = decltype( x * mjk::intmax_constant<Num>{} / mjk::intmax_constant<Den>{} );
+			constexpr int up = twos( Num ), down = twos( Den );
+			constexpr intmax_t num = Num / (intmax_t{1} << up), den = Den / (intmax_t{1} << down);
+			I y = static_cast<I>( x );
+			if ( num != 1 ) y *= static_cast<I>( num );
+			y = shift_up<up>( y );
+			I q = y;
+			if ( den != 1 ) q /= static_cast<I>( den );
+			q = shift_down<down>( q );
+			return Den == 1 ? q : rounded<Den>( y, q, mode );
+		}
+		template<intmax_t Num, intmax_t Den, typename T, typename Mode>
+		inline constexpr auto scale_count( const T &x, std::false_type /*floating*/, Mode ) noexcept
+		{
+			static_assert( std::is_same<Mode, rounding::toward_zero>::value,
+				"rounding floating-point conversion" );
+			using F = decltype( x * mjk::intmax_constant<Num>{} / mjk::intmax_constant<Den>{} );
+			constexpr int up = twos( Num ), down = twos( Den );
+			constexpr intmax_t num = Num / (intmax_t{1} << up), den = Den / (intmax_t{1} << down);
+			F y = x;
+			if ( num != 1 ) y = y * static_cast<F>( num );
+			if ( den != 1 ) y = y / static_cast<F>( den );
+			return up == down ? y : y * pow2<F>( up - down );
+		}
+		// anything else, as is, and x itself when there's nothing to scale by,
+		// so that an rvalue of a heavyweight type is passed on, not copied
+		template<intmax_t Num, intmax_t Den, typename T>
+		inline constexpr decltype(auto) scale_generic( T &&x, std::true_type /*by one*/ ) noexcept
+		{ return std::forward<T>( x ); }
+		template<intmax_t Num, intmax_t Den, typename T>
+		inline constexpr auto scale_generic( T &&x, std::false_type )
+			noexcept(noexcept( std::forward<T>( x ) * mjk::intmax_constant<Num>{} / mjk::intmax_constant<Den>{} ))
+		{ return std::forward<T>( x ) * mjk::intmax_constant<Num>{} / mjk::intmax_constant<Den>{}; }
+		template<intmax_t Num, intmax_t Den, typename T, typename Mode>
+		inline constexpr decltype(auto) scale_count( T &&x, std::nullptr_t, Mode )
+			noexcept(noexcept( scale_generic<Num, Den>( std::forward<T>( x ),
+				std::integral_constant< bool, Num == 1 && Den == 1 >{} ) ))
+		{
+			static_assert( std::is_same<Mode, rounding::toward_zero>::value,
+				"rounding conversion of non-integer data type" );
+			return scale_generic<Num, Den>( std::forward<T>( x ),
+				std::integral_constant< bool, Num == 1 && Den == 1 >{} );
+		}
+
+		template<typename D>
+		using scale_tag = std::conditional_t< std::is_floating_point<D>::value, std::false_type,
+			std::conditional_t< std::is_integral<D>::value, std::true_type, std::nullptr_t > >;
+
+		template<intmax_t Num, intmax_t Den, typename T, typename Mode = rounding::toward_zero>
+		inline constexpr decltype(auto) scale_count( T &&x, Mode mode = {} )
+			noexcept(noexcept( scale_count<Num, Den>( std::forward<T>( x ), scale_tag<std::decay_t<T>>{}, mode ) ))
+		{ return scale_count<Num, Den>( std::forward<T>( x ), scale_tag<std::decay_t<T>>{}, mode ); }
+	}
+
 	template<typename T, typename Unit>
 	class quantity;
 
+	namespace impl
+	{
+		template<typename T>
+		struct is_quantity : std::false_type {};
+		template<typename T, typename Unit>
+		struct is_quantity< quantity<T, Unit> > : std::true_type {};
+	}
+
 	template<typename T, typename Dim, typename Scale>
 	class quantity< T, unit<Dim, Scale> >
 	{
 		T val;
 
-		using unit_type = unit<Dim, Scale>;
+		using unit_type = dimensional::unit<Dim, Scale>;
 		using this_type = quantity<T, unit_type>;
 
 	public:
 		constexpr quantity() = default;
-		explicit constexpr quantity( const T &val ) : val(val) {}
+		explicit constexpr quantity( const T &val )
+			noexcept(std::is_nothrow_copy_constructible<T>::value)
+			: val(val)
+		{ static_assert( as_good_as_T(), "" ); }
+		explicit constexpr quantity( T &&val )
+			noexcept(std::is_nothrow_move_constructible<T>::value)
+			: val(std::move(val))
+		{ static_assert( as_good_as_T(), "" ); }
 
 		template<typename TR, typename DimR, typename ScaleR>
-		constexpr quantity( const quantity<TR, unit<DimR, ScaleR>> &rhs )
+		constexpr quantity( const quantity<TR, dimensional::unit<DimR, ScaleR>> &rhs )
+			noexcept(noexcept( T( rhs.to( scale ).count() ) ))
 			: val( rhs.to( scale ).count() )
 		{
 			static_assert( rhs.dimension == dimension,
 				"converting from quantity with different dimension" );
 		}
+		template<typename TR, typename DimR, typename ScaleR>
+		constexpr quantity( quantity<TR, dimensional::unit<DimR, ScaleR>> &&rhs )
+			noexcept(noexcept( T( std::move(rhs).to( scale ).count() ) ))
+			: val( std::move(rhs).to( scale ).count() )
+		{
+			static_assert( quantity<TR, dimensional::unit<DimR, ScaleR>>::dimension == dimension,
+				"converting from quantity with different dimension" );
+		}
 
 		template<
 			typename U,
 			typename _conv = mjk::conversion< U, this_type >,
 			typename _enabler = decltype(_conv{}) >
 		constexpr quantity( const U &other )
+			noexcept(noexcept( T( _conv{}(other).count() ) ))
 			: val( _conv{}(other).count() )
 		{}
 
@@ -232,39 +568,65 @@ namespace dimensional
 			typename _conv = mjk::conversion< this_type, U >,
 			typename _enabler = decltype(_conv{}) >
 		operator U() const
+			noexcept(noexcept( U( _conv{}( std::declval<const this_type &>() ) ) ))
 		{
 			return _conv{}( *this );
 		}
 
-		template<intmax_t Num, intmax_t Den>
-		constexpr auto to( constant<Num, Den> c ) const
+		// of an rvalue, the count is moved from rather than copied
+		template<intmax_t Num, intmax_t Den, typename Mode = rounding::toward_zero>
+		constexpr auto to( constant<Num, Den> c, Mode mode = {} ) const &
+			noexcept(noexcept( scaled_to( val, c, mode ) ))
+		{ return scaled_to( val, c, mode ); }
+		template<intmax_t Num, intmax_t Den, typename Mode = rounding::toward_zero>
+		constexpr auto to( constant<Num, Den> c, Mode mode = {} ) &&
+			noexcept(noexcept( scaled_to( std::move(val), c, mode ) ))
+		{ return scaled_to( std::move(val), c, mode ); }
+		template<typename ToDim, typename ToScale, typename Mode = rounding::toward_zero>
+		constexpr auto to( dimensional::unit<ToDim, ToScale> u, Mode mode = {} ) const &
+			noexcept(noexcept( scaled_to( std::declval<const T &>(), u.scale, mode ) ))
 		{
-			using s = decltype(scale / c);
-			using num = decltype(s::num);
-			using den = decltype(s::den);
-			return T(count()*num{}/den{}) * (c * unit_of(dimension));
+			static_assert( u.dimension == dimension,
+				"converting quantity to unit with different dimension" );
+			return to( u.scale, mode );
 		}
-		template<typename ToDim, typename ToScale>
-		constexpr auto to( unit<ToDim, ToScale> u ) const
+		template<typename ToDim, typename ToScale, typename Mode = rounding::toward_zero>
+		constexpr auto to( dimensional::unit<ToDim, ToScale> u, Mode mode = {} ) &&
+			noexcept(noexcept( scaled_to( std::declval<T>(), u.scale, mode ) ))
 		{
 			static_assert( u.dimension == dimension,
 				"converting quantity to unit with different dimension" );
-			return to( u.scale );
+			return std::move(*this).to( u.scale, mode );
 		}
 
 		template<typename TR, typename UnitR>
 		quantity &operator+=( const quantity<TR, UnitR> &rhs )
+			noexcept(noexcept( *this = std::move(*this) + rhs ))
+		{
+			return *this = std::move(*this) + rhs;
+		}
+		template<typename TR, typename UnitR>
+		quantity &operator+=( quantity<TR, UnitR> &&rhs )
+			noexcept(noexcept( *this = std::move(*this) + std::move(rhs) ))
 		{
-			return *this = *this + rhs;
+			return *this = std::move(*this) + std::move(rhs);
 		}
 		template<typename TR, typename UnitR>
 		quantity &operator-=( const quantity<TR, UnitR> &rhs )
+			noexcept(noexcept( *this = std::move(*this) - rhs ))
+		{
+			return *this = std::move(*this) - rhs;
+		}
+		template<typename TR, typename UnitR>
+		quantity &operator-=( quantity<TR, UnitR> &&rhs )
+			noexcept(noexcept( *this = std::move(*this) - std::move(rhs) ))
 		{
-			return *this = *this - rhs;
+			return *this = std::move(*this) - std::move(rhs);
 		}
 
 
-		constexpr const auto &count() const { return val; }
+		constexpr const auto &count() const & noexcept { return val; }
+		constexpr T &&count() && noexcept { return std::move(val); }
 
 		static constexpr meta::type<T> type{};
 		static constexpr unit_type unit{};
@@ -272,8 +634,60 @@ namespace dimensional
 		static constexpr auto scale = unit.scale;
 		static constexpr auto num = scale.num;
 		static constexpr auto den = scale.den;
+
+	private:
+		template<typename V, intmax_t Num, intmax_t Den, typename Mode,
+			typename S = decltype(scale / constant<Num, Den>{})>
+		static constexpr auto scaled_to( V &&v, constant<Num, Den> c, Mode mode )
+			noexcept(noexcept( T( impl::scale_count< decltype(S::num)::value, decltype(S::den)::value >(
+				std::forward<V>(v), mode ) ) * (c * unit_of(dimension)) ))
+		{
+			using num = decltype(S::num);
+			using den = decltype(S::den);
+			return T( impl::scale_count< num::value, den::value >( std::forward<V>(v), mode ) ) *
+				(c * unit_of(dimension));
+		}
+
+		// what T guarantees, a quantity of T guarantees too, its layout
+		// included, so that arrays of T can be viewed as ones of quantities
+		// (checked here, with the class complete)
+		static constexpr bool as_good_as_T()
+		{
+			static_assert( sizeof(quantity) == sizeof(T) && alignof(quantity) == alignof(T),
+				"quantity isn't laid out as its data type" );
+			static_assert( !std::is_standard_layout<T>::value ||
+				std::is_standard_layout<quantity>::value,
+				"quantity of standard-layout type isn't" );
+			static_assert( !std::is_nothrow_move_constructible<T>::value ||
+				std::is_nothrow_move_constructible<quantity>::value,
+				"quantity of nothrow move-constructible type throws on move" );
+			static_assert( !std::is_nothrow_move_assignable<T>::value ||
+				std::is_nothrow_move_assignable<quantity>::value,
+				"quantity of nothrow move-assignable type throws on move" );
+			static_assert( !std::is_nothrow_copy_constructible<T>::value ||
+				std::is_nothrow_copy_constructible<quantity>::value,
+				"quantity of nothrow copy-constructible type throws on copy" );
+			static_assert( !std::is_trivially_copyable<T>::value ||
+				std::is_trivially_copyable<quantity>::value,
+				"quantity of trivially copyable type isn't" );
+			return true;
+		}
 	};
 
+	namespace impl
+	{
+		// counts of an array of one-member wrappers of them (quantities,
+		// say), in place
+		template<typename Count, typename Wrapper>
+		inline Count *counts_in( Wrapper *data ) noexcept
+		{
+			static_assert( std::is_standard_layout<Wrapper>::value &&
+				sizeof(Wrapper) == sizeof(Count) && alignof(Wrapper) == alignof(Count),
+				"viewing type not laid out as its count" );
+			return reinterpret_cast<Count *>( data );
+		}
+	}
+
 #ifdef VERYDEBUG
 	template
 	<
@@ -289,36 +703,162 @@ namespace dimensional
 
 	template<typename DataType, typename Dim, typename Scale>
 	inline constexpr auto make_quantity( const DataType &val, unit<Dim, Scale> u = unitless )
+		noexcept(noexcept( quantity< DataType, decltype(u) >{ val } ))
 	{ return quantity< DataType, decltype(u) >{ val }; }
+	template<typename DataType, typename Dim, typename Scale, typename = std::enable_if_t<
+		!std::is_lvalue_reference<DataType>::value && std::is_class<DataType>::value >>
+	inline constexpr auto make_quantity( DataType &&val, unit<Dim, Scale> u = unitless )
+		noexcept(noexcept( quantity< DataType, decltype(u) >{ std::move(val) } ))
+	{ return quantity< DataType, decltype(u) >{ std::move(val) }; }
 
 	// T * unit
 	template<typename DataType, typename Dim, typename Scale>
 	inline constexpr auto operator*( const DataType &value, unit<Dim, Scale> u )
+		noexcept(noexcept( make_quantity( value, u ) ))
 	{ return make_quantity( value, u ); }
+	template<typename DataType, typename Dim, typename Scale, typename = std::enable_if_t<
+		!std::is_lvalue_reference<DataType>::value && std::is_class<DataType>::value >>
+	inline constexpr auto operator*( DataType &&value, unit<Dim, Scale> u )
+		noexcept(noexcept( make_quantity( std::move(value), u ) ))
+	{ return make_quantity( std::move(value), u ); }
 
 	// quant * unit
 	template<typename DataType, typename Unit, typename Dim, typename Scale>
 	inline constexpr auto
 	operator*( const quantity<DataType, Unit> &a, unit<Dim, Scale> u )
+		noexcept(noexcept( a.count() * (Unit{} * u) ))
 	{ return a.count() * (Unit{} * u); }
+	template<typename DataType, typename Unit, typename Dim, typename Scale>
+	inline constexpr auto
+	operator*( quantity<DataType, Unit> &&a, unit<Dim, Scale> u )
+		noexcept(noexcept( std::move(a).count() * (Unit{} * u) ))
+	{ return std::move(a).count() * (Unit{} * u); }
 
 	// +quant
 	template<typename DataType, typename Unit>
 	inline constexpr auto
 	operator+( const quantity<DataType, Unit> &q )
+		noexcept(std::is_nothrow_copy_constructible<DataType>::value)
 	{ return q; }
+	template<typename DataType, typename Unit>
+	inline constexpr auto
+	operator+( quantity<DataType, Unit> &&q )
+		noexcept(noexcept( quantity<DataType, Unit>{ std::move(q) } ))
+	{ return quantity<DataType, Unit>{ std::move(q) }; }
 
 	// quant / unit
 	template<typename DataType, typename Unit, typename Dim, typename Scale>
 	inline constexpr auto
 	operator/( const quantity<DataType, Unit> &a, unit<Dim, Scale> u )
+		noexcept(noexcept( a.count() * (Unit{} / u) ))
 	{ return a.count() * (Unit{} / u); }
+	template<typename DataType, typename Unit, typename Dim, typename Scale>
+	inline constexpr auto
+	operator/( quantity<DataType, Unit> &&a, unit<Dim, Scale> u )
+		noexcept(noexcept( std::move(a).count() * (Unit{} / u) ))
+	{ return std::move(a).count() * (Unit{} / u); }
+
+
+	//   The binary operators below take their operands by const & for the
+	// usual case and, should an operand of a class data type be an rvalue,
+	// by forwarding reference instead, so that T's own rvalue operators can
+	// reuse its resources (e.g. a big number's buffer). Next to a quantity of
+	// T, the other operand of the latter is limited to numbers and T itself,
+	// so as not to take over the overloads of others for quantities.
+	namespace impl
+	{
+		template<typename Q>
+		using count_type = std::decay_t<decltype( std::declval<Q>().count() )>;
+
+		// the T of a quantity operand, or a number operand itself
+		template<typename X, bool = is_quantity<std::decay_t<X>>::value>
+		struct payload { using type = std::decay_t<X>; };
+		template<typename X>
+		struct payload<X, true> { using type = count_type<X>; };
+
+		template<typename X>
+		using worth_moving = std::integral_constant< bool,
+			!std::is_lvalue_reference<X>::value && std::is_class<typename payload<X>::type>::value >;
+
+		// S is a number or T, next to quantity Q of T
+		template<typename S, typename Q, bool = is_quantity<std::decay_t<Q>>::value>
+		struct is_scalar_for : std::false_type {};
+		template<typename S, typename Q>
+		struct is_scalar_for<S, Q, true> : std::integral_constant< bool,
+			!is_quantity<std::decay_t<S>>::value &&
+			(!std::is_class<std::decay_t<S>>::value ||
+			 std::is_same<std::decay_t<S>, count_type<Q>>::value) > {};
+
+		template<typename A, typename B>
+		using is_quantity_pair = std::integral_constant< bool,
+			is_quantity<std::decay_t<A>>::value && is_quantity<std::decay_t<B>>::value >;
+
+		template<bool Operands, typename A, typename B>
+		using enable_moving = std::enable_if_t< Operands &&
+			(worth_moving<A>::value || worth_moving<B>::value) >;
+
+		// quant + quant, quant - quant
+		template<typename A, typename B>
+		using enable_moving_sum = enable_moving< is_quantity_pair<A, B>::value, A, B >;
+		// quant * quant, quant * T, T * quant
+		template<typename A, typename B>
+		using enable_moving_product = enable_moving< is_quantity_pair<A, B>::value ||
+			is_scalar_for<A, B>::value || is_scalar_for<B, A>::value, A, B >;
+		// quant / quant, quant / T
+		template<typename A, typename B>
+		using enable_moving_quotient = enable_moving< is_quantity_pair<A, B>::value ||
+			is_scalar_for<B, A>::value, A, B >;
+
+		// count and unit of a quantity operand, or a number and no unit
+		template<typename X>
+		inline constexpr decltype(auto) count_of( X &&x, std::true_type /*quantity*/ )
+			noexcept(noexcept( std::forward<X>(x).count() ))
+		{ return std::forward<X>(x).count(); }
+		template<typename X>
+		inline constexpr decltype(auto) count_of( X &&x, std::false_type )
+			noexcept
+		{ return std::forward<X>(x); }
+		template<typename X>
+		inline constexpr decltype(auto) count_of( X &&x )
+			noexcept(noexcept( count_of( std::forward<X>(x), is_quantity<std::decay_t<X>>{} ) ))
+		{ return count_of( std::forward<X>(x), is_quantity<std::decay_t<X>>{} ); }
+
+		template<typename Q>
+		using unit_t = std::decay_t<decltype( std::decay_t<Q>::unit )>;
+		template<typename A, typename B>
+		inline constexpr auto unit_times( std::true_type, std::true_type )
+			noexcept
+		{ return unit_t<A>{} * unit_t<B>{}; }
+		template<typename A, typename B>
+		inline constexpr auto unit_times( std::true_type, std::false_type )
+			noexcept
+		{ return unit_t<A>{}; }
+		template<typename A, typename B>
+		inline constexpr auto unit_times( std::false_type, std::true_type )
+			noexcept
+		{ return unit_t<B>{}; }
+		template<typename A, typename B>
+		inline constexpr auto unit_over( std::true_type, std::true_type )
+			noexcept
+		{ return unit_t<A>{} / unit_t<B>{}; }
+		template<typename A, typename B>
+		inline constexpr auto unit_over( std::true_type, std::false_type )
+			noexcept
+		{ return unit_t<A>{}; }
+		template<typename A, typename B>
+		using product_unit = decltype( unit_times<A, B>(
+			is_quantity<std::decay_t<A>>{}, is_quantity<std::decay_t<B>>{} ) );
+		template<typename A, typename B>
+		using quotient_unit = decltype( unit_over<A, B>(
+			is_quantity<std::decay_t<A>>{}, is_quantity<std::decay_t<B>>{} ) );
+	}
 
 	// quant * quant
 	template<typename TA, typename TB, typename UnitA, typename UnitB>
 	inline constexpr auto
 	operator*( const quantity<TA, UnitA> &a,
 			   const quantity<TB, UnitB> &b )
+		noexcept(noexcept( (a.count() * b.count()) * (UnitA{} * UnitB{}) ))
 	{ return (a.count() * b.count()) * (UnitA{} * UnitB{}); }
 
 	// quant / quant
@@ -326,26 +866,50 @@ namespace dimensional
 	inline constexpr auto
 	operator/( const quantity<TA, UnitA> &a,
 			   const quantity<TB, UnitB> &b )
+		noexcept(noexcept( (a.count() / b.count()) * (UnitA{} / UnitB{}) ))
 	{ return (a.count() / b.count()) * (UnitA{} / UnitB{}); }
 
 	// T * quant
 	template<typename DataTypeA, typename DataTypeB, typename Unit>
 	inline constexpr auto
 	operator*( const DataTypeA &a, const quantity<DataTypeB, Unit> &b )
+		noexcept(noexcept( (a * b.count()) * b.unit ))
 	{ return (a * b.count()) * b.unit; }
 
 	// quant * T
 	template<typename DataTypeA, typename DataTypeB, typename Unit>
 	inline constexpr auto
 	operator*( const quantity<DataTypeA, Unit> &a, const DataTypeB &b )
+		noexcept(noexcept( (a.count() * b) * Unit{} ))
 	{ return (a.count() * b) * Unit{}; }
 
 	// quant / T
 	template<typename DataTypeA, typename DataTypeB, typename Unit>
 	inline constexpr auto
 	operator/( const quantity<DataTypeA, Unit> &a, const DataTypeB &b )
+		noexcept(noexcept( (a.count() / b) * Unit{} ))
 	{ return (a.count() / b) * Unit{}; }
 
+	// the same, with rvalues
+	template<typename A, typename B, typename = impl::enable_moving_product<A, B>>
+	inline constexpr auto
+	operator*( A &&a, B &&b )
+		noexcept(noexcept( (impl::count_of( std::forward<A>(a) ) * impl::count_of( std::forward<B>(b) )) *
+			impl::product_unit<A, B>{} ))
+	{
+		return (impl::count_of( std::forward<A>(a) ) * impl::count_of( std::forward<B>(b) )) *
+			impl::product_unit<A, B>{};
+	}
+	template<typename A, typename B, typename = impl::enable_moving_quotient<A, B>>
+	inline constexpr auto
+	operator/( A &&a, B &&b )
+		noexcept(noexcept( (impl::count_of( std::forward<A>(a) ) / impl::count_of( std::forward<B>(b) )) *
+			impl::quotient_unit<A, B>{} ))
+	{
+		return (impl::count_of( std::forward<A>(a) ) / impl::count_of( std::forward<B>(b) )) *
+			impl::quotient_unit<A, B>{};
+	}
+
 	// sqrt( quant )
 	template<typename DataType, typename Unit>
 	inline auto sqrt( const quantity<DataType, Unit> &q )
@@ -355,6 +919,77 @@ namespace dimensional
 	}
 
 
+	//   What to do when bringing an integer operand of a heterogeneous
+	// operation to the common scale overflows. Only mixed scales get checked:
+	// with equal ones, the factors are 1, and the policies compile to nothing.
+	namespace overflow
+	{
+		// T(x*factor), as ever: undefined for signed T, wraps around for unsigned
+		struct unchecked {};
+		// throws std::overflow_error
+		struct checked {};
+		// clamps to the limits of T
+		struct saturating {};
+		// scales in widened<T>::type instead, which is then the result's type
+		struct widening {};
+	}
+
+	// the policy for quantities of data type T
+	// to be user-specialized, e.g. with overflow::checked for std::int64_t
+	template<typename T>
+	struct overflow_policy
+	{
+		using type = overflow::unchecked;
+	};
+
+	namespace impl
+	{
+		// the integer type of the size and signedness, if there's one
+		template<std::size_t Size, bool Signed>
+		struct integer_of_size {};
+		template<> struct integer_of_size<2, true>  { using type = std::int16_t; };
+		template<> struct integer_of_size<4, true>  { using type = std::int32_t; };
+		template<> struct integer_of_size<8, true>  { using type = std::int64_t; };
+		template<> struct integer_of_size<2, false> { using type = std::uint16_t; };
+		template<> struct integer_of_size<4, false> { using type = std::uint32_t; };
+		template<> struct integer_of_size<8, false> { using type = std::uint64_t; };
+#ifdef __SIZEOF_INT128__
+		template<> struct integer_of_size<16, true>  { __extension__ typedef __int128 type; };
+		template<> struct integer_of_size<16, false> { __extension__ typedef unsigned __int128 type; };
+#endif
+
+		template<typename T, bool = std::is_integral<T>::value>
+		struct widened_integer {};
+		template<typename T>
+		struct widened_integer<T, true>
+			: integer_of_size< 2*sizeof(T), std::is_signed<T>::value > {};
+	}
+
+	//   Type twice the size of T, for overflow::widening: for integer types
+	// (char, long long and all) by size and signedness, and none where
+	// there's no wider one. To be user-specialized for other types.
+	template<typename T>
+	struct widened : impl::widened_integer<T> {};
+
+	namespace impl
+	{
+		// widened<T>::type, made sure to be there and wider than T
+		template<typename T, typename = void>
+		struct widening_of
+		{
+			static_assert( !sizeof(T*),
+				"overflow::widening of a type with no widened<T>::type (specialize widened)" );
+			using type = T;
+		};
+		template<typename T>
+		struct widening_of< T, decltype(void( std::declval<typename widened<T>::type>() )) >
+		{
+			using type = typename widened<T>::type;
+			static_assert( sizeof(type) > sizeof(T),
+				"overflow::widening of a type whose widened<T>::type isn't wider" );
+		};
+	}
+
 	// heterogeneous operations (on quantities with different scale):
 	// addition, comparison, etc.
 	namespace impl
@@ -374,39 +1009,133 @@ namespace dimensional
 
 		template<intmax_t A, intmax_t B>
 		inline constexpr auto lcm( c<A>, c<B> )
+			noexcept
 		{ return c< max(A,B) / gcd(c<A>{},c<B>{}) * min(A,B) >{}; }
 
-		template< typename F,
-			typename TA, typename TB, typename UnitA, typename UnitB >
-		inline constexpr auto
-		heterop_raw( F op,
-			const quantity<TA, UnitA> &a, const quantity<TB, UnitB> &b )
+		// the scale both operands are brought to, and the factors doing so
+		template< typename ScaleA, typename ScaleB >
+		struct common_scale
 		{
-			static_assert( a.dimension == b.dimension,
-				"operating on quantities with different dimensions" );
 			//   The aliases in place of static constexpr are due to what seems
 			// like a deficiency in g++ 4.9.0.
-			using num_gcd = c< gcd(a.num, b.num) >;
-			using den_gcd = c< gcd(a.den, b.den) >;
-			//   The following were moved out of the expression, otherwise
-			// num and den suddenly appear before g++ linker with (naturally)
-			// no out-of-class definitions. Another g++ bug, or a C++ defect?
-			using a_scale = c< (a.num/num_gcd{})*(b.den/den_gcd{}) >;
-			using b_scale = c< (b.num/num_gcd{})*(a.den/den_gcd{}) >;
+			using num_gcd = decltype( gcd(ScaleA::num, ScaleB::num) );
+			using den_gcd = decltype( gcd(ScaleA::den, ScaleB::den) );
+			using a_scale = c< (ScaleA::num/num_gcd{})*(ScaleB::den/den_gcd{}) >;
+			using b_scale = c< (ScaleB::num/num_gcd{})*(ScaleA::den/den_gcd{}) >;
+			using type = constant< num_gcd::value, decltype(lcm(ScaleA::den, ScaleB::den))::value >;
+		};
+
+		// an operand brought to the common scale, as per the overflow policy;
+		// unscaled operands are passed on as they are, rvalues as rvalues
+		template<typename T>
+		inline constexpr decltype(auto) scale_by( T &&x, c<1> )
+			noexcept
+		{ return std::forward<T>( x ); }
+		template<typename T, intmax_t Factor>
+		inline constexpr auto scale_by( T &&x, c<Factor> )
+			noexcept(noexcept( std::decay_t<T>( scale_count<Factor, 1>( std::forward<T>( x ) ) ) ))
+		{ return std::decay_t<T>( scale_count<Factor, 1>( std::forward<T>( x ) ) ); }
+		template<typename T, intmax_t Factor>
+		inline constexpr decltype(auto) scale_operand( overflow::unchecked, T &&x, c<Factor> f )
+			noexcept(noexcept( scale_by( std::forward<T>( x ), f ) ))
+		{ return scale_by( std::forward<T>( x ), f ); }
+
+		// checked and saturating: nothing to check but integers by other than 1
+		template<typename Policy, typename T, intmax_t Factor>
+		inline constexpr decltype(auto) scale_integer( Policy, T &&x, c<Factor> f, std::false_type )
+			noexcept(noexcept( scale_operand( overflow::unchecked{}, std::forward<T>( x ), f ) ))
+		{ return scale_operand( overflow::unchecked{}, std::forward<T>( x ), f ); }
+		template<typename T, intmax_t Factor>
+		inline constexpr T scale_integer( overflow::checked, const T &x, c<Factor>, std::true_type )
+		{
+			T res{};
+			if ( __builtin_mul_overflow( x, Factor, &res ) )
+				throw std::overflow_error{ "bringing quantity to common scale" };
+			return res;
+		}
+		template<typename T, intmax_t Factor>
+		inline constexpr T scale_integer( overflow::saturating, const T &x, c<Factor>, std::true_type ) noexcept
+		{
+			T res{};
+			if ( __builtin_mul_overflow( x, Factor, &res ) )
+				return (x < T{}) != (Factor < 0) ?
+					std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+			return res;
+		}
+		template<typename T, intmax_t Factor>
+		using checks = std::integral_constant< bool,
+			std::is_integral<std::decay_t<T>>::value && Factor != 1 >;
+
+		template<typename T, intmax_t Factor>
+		inline constexpr decltype(auto) scale_operand( overflow::checked p, T &&x, c<Factor> f )
+			noexcept(noexcept( scale_integer( p, std::forward<T>( x ), f, checks<T, Factor>{} ) ))
+		{ return scale_integer( p, std::forward<T>( x ), f, checks<T, Factor>{} ); }
+		template<typename T, intmax_t Factor>
+		inline constexpr decltype(auto) scale_operand( overflow::saturating p, T &&x, c<Factor> f )
+			noexcept(noexcept( scale_integer( p, std::forward<T>( x ), f, checks<T, Factor>{} ) ))
+		{ return scale_integer( p, std::forward<T>( x ), f, checks<T, Factor>{} ); }
+
+		template<typename T, intmax_t Factor>
+		inline constexpr auto scale_operand( overflow::widening, T &&x, c<Factor> f )
+			noexcept(noexcept( scale_by( typename widening_of<std::decay_t<T>>::type( std::forward<T>( x ) ), f ) ))
+		{
+			using wide = typename widening_of<std::decay_t<T>>::type;
+			return scale_by( wide( std::forward<T>( x ) ), f );
+		}
+
+		//   The following were moved out of the expression, otherwise
+		// num and den suddenly appear before g++ linker with (naturally)
+		// no out-of-class definitions. Another g++ bug, or a C++ defect?
+		template< typename A, typename B >
+		using common_scale_of = common_scale<
+			decltype(+std::decay_t<A>::scale), decltype(+std::decay_t<B>::scale) >;
+
+		// (of quantities A and B, forwarded)
+		template< typename F, typename A, typename B, typename PolicyA, typename PolicyB >
+		inline constexpr auto
+		heterop_raw( F op, A &&a, B &&b, PolicyA policy_a, PolicyB policy_b )
+			noexcept(noexcept( op
+			(
+				scale_operand( policy_a, std::forward<A>(a).count(), typename common_scale_of<A, B>::a_scale{} ),
+				scale_operand( policy_b, std::forward<B>(b).count(), typename common_scale_of<A, B>::b_scale{} )
+			) ))
+		{
+			static_assert( std::decay_t<A>::dimension == std::decay_t<B>::dimension,
+				"operating on quantities with different dimensions" );
+			using a_scale = typename common_scale_of<A, B>::a_scale;
+			using b_scale = typename common_scale_of<A, B>::b_scale;
 			return op
 			(
-				TA( a.count() * a_scale{} ),
-				TB( b.count() * b_scale{} )
+				scale_operand( policy_a, std::forward<A>(a).count(), a_scale{} ),
+				scale_operand( policy_b, std::forward<B>(b).count(), b_scale{} )
 			);
 		}
-
 		template< typename F, typename A, typename B >
 		inline constexpr auto
-		heterop( F op, const A &a, const B &b )
+		heterop_raw( F op, A &&a, B &&b )
+			noexcept(noexcept( heterop_raw( op, std::forward<A>(a), std::forward<B>(b),
+				typename overflow_policy<count_type<A>>::type{},
+				typename overflow_policy<count_type<B>>::type{} ) ))
+		{
+			return heterop_raw( op, std::forward<A>(a), std::forward<B>(b),
+				typename overflow_policy<count_type<A>>::type{},
+				typename overflow_policy<count_type<B>>::type{} );
+		}
+
+		// unit of the results of heterop
+		template< typename UnitA, typename UnitB >
+		using common_unit = decltype(
+			typename common_scale< decltype(+UnitA::scale), decltype(+UnitB::scale) >::type{}
+			* unit_of(UnitA::dimension) );
+
+		template< typename F, typename A, typename B, typename... Policies >
+		inline constexpr auto
+		heterop( F op, A &&a, B &&b, Policies... policies )
+			noexcept(noexcept( heterop_raw( op, std::forward<A>(a), std::forward<B>(b), policies... ) *
+				common_unit< unit_t<A>, unit_t<B> >{} ))
 		{
-			using common_scale = constant< gcd(a.num, b.num), lcm(a.den, b.den) >;
-			using common_unit  = decltype( common_scale{} * unit_of(a.dimension) );
-			return heterop_raw(op,a,b) * common_unit{};
+			return heterop_raw( op, std::forward<A>(a), std::forward<B>(b), policies... ) *
+				common_unit< unit_t<A>, unit_t<B> >{};
 		}
 	}
 
@@ -414,27 +1143,66 @@ namespace dimensional
 	template< typename TA, typename TB, typename UnitA, typename UnitB >
 	inline constexpr auto
 	operator+( const quantity<TA, UnitA> &a, const quantity<TB, UnitB> &b )
+		noexcept(noexcept( impl::heterop( mjk::plus, a, b ) ))
 	{ return impl::heterop( mjk::plus, a, b ); }
 	// quant - quant
 	template< typename TA, typename TB, typename UnitA, typename UnitB >
 	inline constexpr auto
 	operator-( const quantity<TA, UnitA> &a, const quantity<TB, UnitB> &b )
+		noexcept(noexcept( impl::heterop( mjk::minus, a, b ) ))
 	{ return impl::heterop( mjk::minus, a, b ); }
+	// the same, with rvalues
+	template< typename A, typename B, typename = impl::enable_moving_sum<A, B> >
+	inline constexpr auto
+	operator+( A &&a, B &&b )
+		noexcept(noexcept( impl::heterop( mjk::plus, std::forward<A>(a), std::forward<B>(b) ) ))
+	{ return impl::heterop( mjk::plus, std::forward<A>(a), std::forward<B>(b) ); }
+	template< typename A, typename B, typename = impl::enable_moving_sum<A, B> >
+	inline constexpr auto
+	operator-( A &&a, B &&b )
+		noexcept(noexcept( impl::heterop( mjk::minus, std::forward<A>(a), std::forward<B>(b) ) ))
+	{ return impl::heterop( mjk::minus, std::forward<A>(a), std::forward<B>(b) ); }
 	// quant < quant
 	template< typename TA, typename TB, typename UnitA, typename UnitB >
 	inline constexpr auto
 	operator<( const quantity<TA, UnitA> &a, const quantity<TB, UnitB> &b )
+		noexcept(noexcept( impl::heterop_raw( mjk::less, a, b ) ))
 	{ return impl::heterop_raw( mjk::less, a, b ); }
 	// quant <= quant
 	template< typename TA, typename TB, typename UnitA, typename UnitB >
 	inline constexpr auto
 	operator<=( const quantity<TA, UnitA> &a, const quantity<TB, UnitB> &b )
+		noexcept(noexcept( !(b < a) ))
 	{ return !(b < a); }
 	// quant == quant
 	template< typename TA, typename TB, typename UnitA, typename UnitB >
 	inline constexpr auto
 	operator==( const quantity<TA, UnitA> &a, const quantity<TB, UnitB> &b )
+		noexcept(noexcept( impl::heterop_raw( mjk::equal_to, a, b ) ))
 	{ return impl::heterop_raw( mjk::equal_to, a, b ); }
+
+	// the same, with an overflow policy for both operands given per call:
+	// add( overflow::checked{}, INT_MAX*kg, 0*g ) throws
+	template< typename Policy, typename TA, typename TB, typename UnitA, typename UnitB >
+	inline constexpr auto
+	add( Policy p, const quantity<TA, UnitA> &a, const quantity<TB, UnitB> &b )
+		noexcept(noexcept( impl::heterop( mjk::plus, a, b, p, p ) ))
+	{ return impl::heterop( mjk::plus, a, b, p, p ); }
+	template< typename Policy, typename TA, typename TB, typename UnitA, typename UnitB >
+	inline constexpr auto
+	subtract( Policy p, const quantity<TA, UnitA> &a, const quantity<TB, UnitB> &b )
+		noexcept(noexcept( impl::heterop( mjk::minus, a, b, p, p ) ))
+	{ return impl::heterop( mjk::minus, a, b, p, p ); }
+	template< typename Policy, typename TA, typename TB, typename UnitA, typename UnitB >
+	inline constexpr auto
+	less( Policy p, const quantity<TA, UnitA> &a, const quantity<TB, UnitB> &b )
+		noexcept(noexcept( impl::heterop_raw( mjk::less, a, b, p, p ) ))
+	{ return impl::heterop_raw( mjk::less, a, b, p, p ); }
+	template< typename Policy, typename TA, typename TB, typename UnitA, typename UnitB >
+	inline constexpr auto
+	equal( Policy p, const quantity<TA, UnitA> &a, const quantity<TB, UnitB> &b )
+		noexcept(noexcept( impl::heterop_raw( mjk::equal_to, a, b, p, p ) ))
+	{ return impl::heterop_raw( mjk::equal_to, a, b, p, p ); }
 }
 
 #endif
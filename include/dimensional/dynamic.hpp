@@ -0,0 +1,403 @@
+// dimensions known at run time only: the exponents of interned dimension
+// tags, packed into a pair of words
+
+#ifndef DIMENSIONAL_DYNAMIC_H
+#define DIMENSIONAL_DYNAMIC_H
+
+#include "dimensional.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace dimensional
+{
+	// thrown by run-time operations on mismatched dimensions
+	struct dimension_error : std::domain_error
+	{
+		using std::domain_error::domain_error;
+	};
+
+
+	// run-time counterpart of constant: a rational number kept reduced,
+	// with den > 0; products and quotients that overflow throw
+	// std::overflow_error
+	struct rational
+	{
+		intmax_t num = 0;
+		intmax_t den = 1;
+
+		constexpr rational() = default;
+		constexpr rational( intmax_t n, intmax_t d = 1 )
+		{
+			if ( d == 0 )
+				throw std::domain_error{ "rational with zero denominator" };
+			const intmax_t g = mjk::sgcd( n, d );
+			num = n / g;
+			den = d / g;
+			if ( den < 0 )
+			{
+				num = -num;
+				den = -den;
+			}
+		}
+		template<intmax_t Num, intmax_t Den>
+		constexpr rational( constant<Num, Den> ) : num(Num), den(Den) {}
+
+		friend rational operator*( rational a, rational b )
+		{
+			const intmax_t g1 = mjk::sgcd( a.num, b.den ), g2 = mjk::sgcd( b.num, a.den );
+			intmax_t n, d;
+			if ( __builtin_mul_overflow( a.num / g1, b.num / g2, &n ) ||
+			     __builtin_mul_overflow( a.den / g2, b.den / g1, &d ) )
+				throw std::overflow_error{ "rational product out of range" };
+			return { n, d };
+		}
+		friend rational operator/( rational a, rational b )
+		{
+			if ( b.num == 0 )
+				throw std::domain_error{ "rational division by zero" };
+			return a * rational{ b.den, b.num };
+		}
+
+		friend constexpr bool operator==( rational a, rational b ) noexcept
+		{ return a.num == b.num && a.den == b.den; }
+		friend constexpr bool operator!=( rational a, rational b ) noexcept
+		{ return !(a == b); }
+	};
+
+	namespace impl
+	{
+		// the exact n-th root of x >= 0, or -1 if there's none
+		inline intmax_t exact_root( intmax_t x, intmax_t n ) noexcept
+		{
+			if ( x < 2 || n == 1 )
+				return x;
+			// 2^n, and any bigger power, is out of range beyond that
+			if ( n >= std::numeric_limits<intmax_t>::digits )
+				return -1;
+			intmax_t lo = 0, hi = x;
+			while ( lo <= hi )
+			{
+				const intmax_t mid = lo + (hi - lo)/2;
+				intmax_t p = 1;
+				bool over = false;
+				for ( intmax_t i = 0; i < n && !over; ++i )
+					over = __builtin_mul_overflow( p, mid, &p ) || p > x;
+				if ( !over && p == x )
+					return mid;
+				if ( over )
+					hi = mid - 1;
+				else
+					lo = mid + 1;
+			}
+			return -1;
+		}
+	}
+
+	// r to the rational power p, which must come out rational,
+	// or else std::range_error is thrown
+	inline rational pow( rational r, rational p )
+	{
+		if ( p.den != 1 )
+		{
+			const bool negative = r.num < 0;
+			if ( negative && p.den % 2 == 0 )
+				throw std::range_error{ "even root of negative rational" };
+			const intmax_t num = impl::exact_root( negative ? -r.num : r.num, p.den ),
+			               den = impl::exact_root( r.den, p.den );
+			if ( num < 0 || den < 0 )
+				throw std::range_error{ "irrational power of rational" };
+			r = rational{ negative ? -num : num, den };
+		}
+		if ( p.num < 0 )
+			r = rational{ 1 } / r;
+		// by squaring, and at once for powers that stay put
+		std::uintmax_t e = p.num < 0 ? 0 - std::uintmax_t( p.num ) : std::uintmax_t( p.num );
+		if ( r.den == 1 && (r.num == 0 || r.num == 1) )
+			return e == 0 ? rational{ 1 } : r;
+		if ( r.den == 1 && r.num == -1 )
+			return e % 2 == 0 ? rational{ 1 } : r;
+		rational res{ 1 };
+		for ( ; e != 0; e /= 2 )
+		{
+			if ( e % 2 != 0 )
+				res = res * r;
+			if ( e > 1 )
+				r = r * r;
+		}
+		return res;
+	}
+
+
+	namespace impl
+	{
+		// FNV-1a, as for dimension_key
+		inline std::uint64_t name_hash( const std::string &name ) noexcept
+		{
+			std::uint64_t hash = 14695981039346656037u;
+			for ( const char c : name )
+				hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211u;
+			return hash;
+		}
+
+		//   The tags of all dyn_dimensions of the process, by dimension_key,
+		// each given the next lane on first sight and never forgotten. Lookups
+		// of known tags take no lock: keys below count are never rewritten.
+		class dimension_lanes
+		{
+		public:
+			static constexpr int capacity = 16;
+
+			static dimension_lanes &get()
+			{
+				static dimension_lanes lanes;
+				return lanes;
+			}
+
+			// the lane of a known tag, or -1, without taking one
+			int find( std::uint64_t key ) const noexcept
+			{
+				const int known = count.load( std::memory_order_acquire );
+				for ( int i = 0; i < known; ++i )
+					if ( keys[i] == key )
+						return i;
+				return -1;
+			}
+
+			int of( std::uint64_t key )
+			{
+				const int known = count.load( std::memory_order_acquire );
+				for ( int i = 0; i < known; ++i )
+					if ( keys[i] == key )
+						return i;
+				std::lock_guard<std::mutex> lock{ m };
+				const int now = count.load( std::memory_order_relaxed );
+				for ( int i = known; i < now; ++i )
+					if ( keys[i] == key )
+						return i;
+				if ( now == capacity )
+					throw std::length_error{ "too many dimension tags for dyn_dimension" };
+				keys[now] = key;
+				count.store( now + 1, std::memory_order_release );
+				return now;
+			}
+
+		private:
+			std::mutex m;
+			std::atomic<int> count{ 0 };
+			std::uint64_t keys[capacity] = {};
+		};
+
+		template<typename Tag>
+		inline int lane_of()
+		{
+			static const int lane = dimension_lanes::get().of( dimension_key<Tag>::value );
+			return lane;
+		}
+	}
+
+	class dyn_dimension;
+	namespace impl
+	{
+		template<typename Dim>
+		inline const dyn_dimension &dyn_of();
+	}
+
+	//   Dimension whose identity isn't part of its type: the exponent of every
+	// tag, in sixths, in a signed byte lane of its own (see dimension_lanes),
+	// 16 lanes packed into two words. Comparison is of the words; products
+	// and quotients are lane-wise sums and differences of them, computed
+	// without branches, but for the check for overflow of a lane.
+	// Converts from any dimension_product, and back with as().
+	class dyn_dimension
+	{
+		std::uint64_t w[2] = {};
+
+		static constexpr std::uint64_t high = 0x8080808080808080u, low = ~high;
+
+		static std::uint64_t add( std::uint64_t a, std::uint64_t b, std::uint64_t &overflow ) noexcept
+		{
+			const std::uint64_t r = ((a & low) + (b & low)) ^ ((a ^ b) & high);
+			overflow |= (a ^ r) & (b ^ r) & high;
+			return r;
+		}
+		static std::uint64_t sub( std::uint64_t a, std::uint64_t b, std::uint64_t &overflow ) noexcept
+		{
+			const std::uint64_t r = ((a | high) - (b & low)) ^ ((a ^ ~b) & high);
+			overflow |= (a ^ b) & (a ^ r) & high;
+			return r;
+		}
+
+		int lane( int i ) const noexcept
+		{ return static_cast<std::int8_t>( static_cast<std::uint8_t>( w[i/8] >> (i%8*8) ) ); }
+		void set_lane( int i, int v ) noexcept
+		{
+			const int shift = i%8*8;
+			w[i/8] = (w[i/8] & ~(std::uint64_t{0xff} << shift)) |
+				std::uint64_t{ static_cast<std::uint8_t>( v ) } << shift;
+		}
+
+		rational exponent_at( int i ) const
+		{ return i < 0 ? rational{ 0 } : rational{ lane( i ), exponent_den }; }
+
+		template<typename Power>
+		struct lane_value
+		{
+			static constexpr intmax_t num = decltype(Power::num)::value, den = decltype(Power::den)::value;
+			static_assert( 6 % den == 0,
+				"dimension exponent not a multiple of 1/6, which dyn_dimension can't hold" );
+			static constexpr intmax_t value = num * (6 / den);
+			static_assert( value >= -128 && value <= 127,
+				"dimension exponent out of the range of dyn_dimension" );
+		};
+
+	public:
+		static constexpr int capacity = impl::dimension_lanes::capacity;
+		// exponents are multiples of 1/exponent_den, from -128 to 127 of them
+		static constexpr int exponent_den = 6;
+
+		// dimensionless
+		constexpr dyn_dimension() = default;
+
+		template<typename... Tags, typename... Powers>
+		dyn_dimension( dimension_product< meta::set< dimension_factor<Tags, Powers>... > > )
+		{
+			const int lanes[] = { 0, (set_lane( impl::lane_of<Tags>(), static_cast<int>( lane_value<Powers>::value ) ), 0)... };
+			(void)lanes;
+		}
+
+		// the base dimension of a tag known by name only (e.g. "USD");
+		// names are hashed into dimension keys
+		static dyn_dimension base( const std::string &name )
+		{
+			dyn_dimension d;
+			d.set_lane( impl::dimension_lanes::get().of( impl::name_hash( name ) ), exponent_den );
+			return d;
+		}
+
+		// the exponent of a base dimension in this one, 0 for tags never
+		// seen, which are looked up without taking a lane
+		template<typename Tag>
+		rational exponent( dimension<Tag> ) const
+		{ return exponent_at( impl::dimension_lanes::get().find( dimension_key<Tag>::value ) ); }
+		rational exponent( const std::string &name ) const
+		{ return exponent_at( impl::dimension_lanes::get().find( impl::name_hash( name ) ) ); }
+
+		bool dimensionless() const noexcept { return (w[0] | w[1]) == 0; }
+
+		template<typename Factors>
+		bool is( dimension_product<Factors> ) const
+		{ return *this == impl::dyn_of< dimension_product<Factors> >(); }
+		// back to the static dimension, which this must be
+		template<typename Factors>
+		auto as( dimension_product<Factors> d ) const
+		{
+			if ( !is( d ) )
+				throw dimension_error{ "dyn_dimension isn't the static one asked for" };
+			return +d;
+		}
+
+		// to the rational power p, which must leave every exponent a multiple
+		// of 1/exponent_den in range, or else std::range_error is thrown
+		dyn_dimension pow( rational p ) const
+		{
+			dyn_dimension res;
+			for ( int i = 0; i < capacity; ++i )
+			{
+				intmax_t v;
+				if ( __builtin_mul_overflow( intmax_t{ lane( i ) }, p.num, &v ) ||
+				     v % p.den != 0 || v / p.den < -128 || v / p.den > 127 )
+					throw std::range_error{ "dyn_dimension exponent not representable" };
+				res.set_lane( i, static_cast<int>( v / p.den ) );
+			}
+			return res;
+		}
+
+		friend dyn_dimension operator*( const dyn_dimension &a, const dyn_dimension &b )
+		{
+			std::uint64_t overflow = 0;
+			dyn_dimension res;
+			res.w[0] = add( a.w[0], b.w[0], overflow );
+			res.w[1] = add( a.w[1], b.w[1], overflow );
+			if ( overflow )
+				throw std::overflow_error{ "dyn_dimension exponent out of range" };
+			return res;
+		}
+		friend dyn_dimension operator/( const dyn_dimension &a, const dyn_dimension &b )
+		{
+			std::uint64_t overflow = 0;
+			dyn_dimension res;
+			res.w[0] = sub( a.w[0], b.w[0], overflow );
+			res.w[1] = sub( a.w[1], b.w[1], overflow );
+			if ( overflow )
+				throw std::overflow_error{ "dyn_dimension exponent out of range" };
+			return res;
+		}
+
+		friend bool operator==( const dyn_dimension &a, const dyn_dimension &b ) noexcept
+		{ return ((a.w[0] ^ b.w[0]) | (a.w[1] ^ b.w[1])) == 0; }
+		friend bool operator!=( const dyn_dimension &a, const dyn_dimension &b ) noexcept
+		{ return !(a == b); }
+
+		std::size_t hash() const noexcept
+		{ return static_cast<std::size_t>( w[0] * 0x9e3779b97f4a7c15u ^ w[1] ); }
+	};
+
+	// unit whose dimension and scale are known at run time only
+	// converts from any unit
+	struct dyn_unit
+	{
+		dyn_dimension dimension;
+		rational scale{ 1 };
+
+		dyn_unit() = default;
+		dyn_unit( dyn_dimension dimension, rational scale = 1 )
+			: dimension(dimension), scale(scale) {}
+		template<typename Dim, typename Scale>
+		dyn_unit( unit<Dim, Scale> ) : dimension( Dim{} ), scale( Scale{} ) {}
+
+		template<typename Dim, typename Scale>
+		bool is( unit<Dim, Scale> ) const
+		{ return scale == rational{ Scale{} } && dimension.is( Dim{} ); }
+
+		dyn_unit pow( rational p ) const
+		{ return { dimension.pow( p ), dimensional::pow( scale, p ) }; }
+
+		friend dyn_unit operator*( const dyn_unit &a, const dyn_unit &b )
+		{ return { a.dimension * b.dimension, a.scale * b.scale }; }
+		friend dyn_unit operator/( const dyn_unit &a, const dyn_unit &b )
+		{ return { a.dimension / b.dimension, a.scale / b.scale }; }
+		friend bool operator==( const dyn_unit &a, const dyn_unit &b ) noexcept
+		{ return a.dimension == b.dimension && a.scale == b.scale; }
+		friend bool operator!=( const dyn_unit &a, const dyn_unit &b ) noexcept
+		{ return !(a == b); }
+	};
+
+	namespace impl
+	{
+		// a static dimension as a dyn_dimension, worked out once
+		template<typename Dim>
+		inline const dyn_dimension &dyn_of()
+		{
+			static const dyn_dimension d{ Dim{} };
+			return d;
+		}
+	}
+}
+
+namespace std
+{
+	template<>
+	struct hash<dimensional::dyn_dimension>
+	{
+		std::size_t operator()( const dimensional::dyn_dimension &d ) const noexcept
+		{ return d.hash(); }
+	};
+}
+
+#endif
@@ -0,0 +1,310 @@
+// scales known at run time only, e.g. rates of exchange or calibration
+// factors: dynamic_scale, global and stateless, for quantities to have, and
+// the per-instance scale of make_scale, which does the converting itself
+
+#ifndef DIMENSIONAL_DYNAMIC_SCALE_H
+#define DIMENSIONAL_DYNAMIC_SCALE_H
+
+#include "dimensional.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace dimensional
+{
+	//   A factor that changes now and then, a rate of exchange, say: each
+	// set() bumps its epoch, which is what the conversion coefficients
+	// worked out from the factor are checked against before use.
+	class scale_source
+	{
+		std::atomic<double> value;
+		std::atomic<std::uint64_t> epochs{ 0 };
+
+		static double checked( double factor )
+		{
+			if ( !(factor > 0) )
+				throw std::domain_error{ "scale_source of non-positive factor" };
+			return factor;
+		}
+
+	public:
+		explicit scale_source( double factor ) : value( checked( factor ) ) {}
+		scale_source( const scale_source & ) = delete;
+		scale_source &operator=( const scale_source & ) = delete;
+
+		// a factor at least as new as the epoch loaded before it
+		double factor() const noexcept
+		{ return value.load( std::memory_order_relaxed ); }
+		std::uint64_t epoch() const noexcept
+		{ return epochs.load( std::memory_order_acquire ); }
+
+		void set( double factor )
+		{
+			value.store( checked( factor ), std::memory_order_relaxed );
+			epochs.fetch_add( 1, std::memory_order_release );
+		}
+	};
+
+
+	namespace impl
+	{
+		// y as per the mode, for integers to take
+		template<typename F>
+		inline F round_as( F y, rounding::toward_zero ) noexcept { return std::trunc( y ); }
+		template<typename F>
+		inline F round_as( F y, rounding::nearest ) noexcept { return std::round( y ); }
+		template<typename F>
+		inline F round_as( F y, rounding::floor ) noexcept { return std::floor( y ); }
+		template<typename F>
+		inline F round_as( F y, rounding::ceil ) noexcept { return std::ceil( y ); }
+
+		// y, or the integer it's within a few ulps of, so that the rounding
+		// error of the ratio doesn't cost a whole unit (100*2.3 is 229.99...)
+		template<typename F>
+		inline F snapped( F y ) noexcept
+		{
+			const F n = std::round( y );
+			return std::abs( y - n ) <= 4 * std::numeric_limits<F>::epsilon() * std::abs( n ) ? n : y;
+		}
+
+		// x times a ratio known at run time only, as a T
+		template<typename T, typename X, typename Mode>
+		inline T scaled_by( const X &x, double ratio, std::true_type /*integer*/, Mode mode ) noexcept
+		{
+			using F = decltype( x * ratio );
+			return T( round_as( snapped( static_cast<F>( x ) * ratio ), mode ) );
+		}
+		template<typename T, typename X, typename Mode>
+		inline T scaled_by( const X &x, double ratio, std::false_type /*floating*/, Mode ) noexcept
+		{
+			static_assert( std::is_same<Mode, rounding::toward_zero>::value,
+				"rounding floating-point conversion" );
+			return T( x * ratio );
+		}
+		template<typename T, typename X, typename Mode>
+		inline T scaled_by( const X &x, double ratio, std::nullptr_t, Mode )
+			noexcept(noexcept( T( x * ratio ) ))
+		{
+			static_assert( std::is_same<Mode, rounding::toward_zero>::value,
+				"rounding conversion of non-integer data type" );
+			return T( x * ratio );
+		}
+		template<typename T, typename X, typename Mode = rounding::toward_zero>
+		inline T scaled_by( const X &x, double ratio, Mode mode = {} )
+			noexcept(noexcept( scaled_by<T>( x, ratio, scale_tag<T>{}, mode ) ))
+		{ return scaled_by<T>( x, ratio, scale_tag<T>{}, mode ); }
+
+		// a scale as a number, and the number of changes to it so far
+		template<intmax_t Num, intmax_t Den>
+		inline constexpr double factor_of( constant<Num,Den> ) noexcept
+		{ return double( Num ) / double( Den ); }
+		template<intmax_t Num, intmax_t Den>
+		inline constexpr std::uint64_t epoch_of( constant<Num,Den> ) noexcept
+		{ return 0; }
+	}
+
+	//   Global and stateless: Source's factor times Static, as the Scale of
+	// a unit, e.g.
+	//     scale_source usd_per_eur{ 1.1 };
+	//     constexpr auto eur = dynamic_scale<usd_per_eur>{} * usd;
+	// so that quantities of it convert implicitly to and from ones of their
+	// dimension in any other unit, without a unit instance at hand. They
+	// don't take part in arithmetic: convert them to a static unit first.
+	template<const scale_source &Source, typename Static = constant<1>>
+	struct dynamic_scale
+	{
+		static double factor() noexcept
+		{ return Source.factor() * impl::factor_of( Static{} ); }
+		static std::uint64_t epoch() noexcept
+		{ return Source.epoch(); }
+	};
+
+	//   Per instance: the factor of a source picked at run time times
+	// Static, with the coefficient taken at construction, or refresh(), and
+	// used for as long as the source's epoch stays the same (worked out anew
+	// in each conversion otherwise). Being state, it has to be at hand to
+	// convert: units of it turn quantities of static units into counts in
+	// them and back.
+	template<typename Static = constant<1>>
+	class instance_scale
+	{
+		const scale_source *src;
+		std::uint64_t epoch_seen;
+		double coefficient, inverse;
+
+	public:
+		explicit instance_scale( const scale_source &source ) noexcept : src(&source)
+		{ refresh(); }
+
+		const scale_source &source() const noexcept { return *src; }
+
+		double factor() const noexcept
+		{
+			return src->epoch() == epoch_seen ? coefficient :
+				src->factor() * impl::factor_of( Static{} );
+		}
+		double inverse_factor() const noexcept
+		{ return src->epoch() == epoch_seen ? inverse : 1 / factor(); }
+
+		bool stale() const noexcept { return src->epoch() != epoch_seen; }
+		void refresh() noexcept
+		{
+			epoch_seen = src->epoch();
+			coefficient = src->factor() * impl::factor_of( Static{} );
+			inverse = 1 / coefficient;
+		}
+	};
+
+	// a scale of the source's factor
+	inline instance_scale<> make_scale( const scale_source &source ) noexcept
+	{ return instance_scale<>{ source }; }
+
+
+	// dynamic_scale * const
+	template<const scale_source &Source, typename Static, intmax_t Num, intmax_t Den>
+	inline constexpr auto operator*( dynamic_scale<Source, Static>, constant<Num,Den> c ) noexcept
+	{ return dynamic_scale<Source, decltype(Static{} * c)>{}; }
+
+	// const * dynamic_scale
+	template<intmax_t Num, intmax_t Den, const scale_source &Source, typename Static>
+	inline constexpr auto operator*( constant<Num,Den> c, dynamic_scale<Source, Static> s ) noexcept
+	{ return s * c; }
+
+	// dynamic_scale * unit
+	template<const scale_source &Source, typename Static, typename Dim, intmax_t Num, intmax_t Den>
+	inline constexpr auto operator*( dynamic_scale<Source, Static>, unit<Dim, constant<Num,Den>> ) noexcept
+	{ return unit<Dim, dynamic_scale<Source, decltype(Static{} * constant<Num,Den>{})>>{}; }
+
+	// instance_scale * unit
+	template<typename Static, typename Dim, intmax_t Num, intmax_t Den>
+	inline auto operator*( instance_scale<Static> s, unit<Dim, constant<Num,Den>> ) noexcept
+	{
+		using scale = instance_scale<decltype(Static{} * constant<Num,Den>{})>;
+		return unit<Dim, scale>{ scale{ s.source() } };
+	}
+
+
+	template<typename Dimension, const scale_source &Source, typename Static>
+	struct unit< Dimension, dynamic_scale<Source, Static> >
+	{
+		static_assert( decltype(impl::is_dimension( (Dimension *)nullptr ))::value,
+			"bad parameters for 'unit': "
+				"'dimension_product' and 'dynamic_scale' expected" );
+		static constexpr auto dimension = Dimension{};
+		static constexpr auto scale     = dynamic_scale<Source, Static>{};
+	};
+
+	template<typename Dimension, typename Static>
+	struct unit< Dimension, instance_scale<Static> >
+	{
+		static_assert( decltype(impl::is_dimension( (Dimension *)nullptr ))::value,
+			"bad parameters for 'unit': "
+				"'dimension_product' and 'instance_scale' expected" );
+		static constexpr auto dimension = Dimension{};
+		instance_scale<Static> scale;
+
+		// q as a count of this unit
+		template<typename T, typename Dim, intmax_t Num, intmax_t Den, typename Mode = rounding::toward_zero>
+		T count_of( const quantity<T, unit<Dim, constant<Num,Den>>> &q, Mode mode = {} ) const
+			noexcept(noexcept( impl::scaled_by<T>( q.count(), 0., mode ) ))
+		{
+			static_assert( Dim{} == dimension,
+				"converting from quantity with different dimension" );
+			return impl::scaled_by<T>( q.count(),
+				impl::factor_of( constant<Num,Den>{} ) * scale.inverse_factor(), mode );
+		}
+		// a count of this unit as a quantity of u
+		template<typename T, typename Dim, intmax_t Num, intmax_t Den, typename Mode = rounding::toward_zero>
+		quantity<T, unit<Dim, constant<Num,Den>>> quantity_of( const T &count, unit<Dim, constant<Num,Den>>, Mode mode = {} ) const
+			noexcept(noexcept( quantity<T, unit<Dim, constant<Num,Den>>>{ impl::scaled_by<T>( count, 0., mode ) } ))
+		{
+			static_assert( Dim{} == dimension,
+				"converting to unit with different dimension" );
+			return quantity<T, unit<Dim, constant<Num,Den>>>{ impl::scaled_by<T>( count,
+				scale.factor() * impl::factor_of( constant<Den,Num>{} ), mode ) };
+		}
+	};
+
+
+	namespace impl
+	{
+		template<const scale_source &Source, typename Static>
+		inline double factor_of( dynamic_scale<Source, Static> s ) noexcept
+		{ return s.factor(); }
+
+		template<const scale_source &Source, typename Static>
+		inline std::uint64_t epoch_of( dynamic_scale<Source, Static> s ) noexcept
+		{ return s.epoch(); }
+
+		//   From/To, kept per thread and worked out anew only when the epoch
+		// of either has moved on, so that a conversion is a load or two, a
+		// compare and a multiply
+		template<typename From, typename To>
+		inline double cached_ratio() noexcept
+		{
+			struct entry { std::uint64_t from, to; double ratio; };
+			static thread_local entry e{ ~std::uint64_t{0}, ~std::uint64_t{0}, 0 };
+			const std::uint64_t from = epoch_of( From{} ), to = epoch_of( To{} );
+			if ( from != e.from || to != e.to )
+				e = { from, to, factor_of( From{} ) / factor_of( To{} ) };
+			return e.ratio;
+		}
+	}
+
+	template<typename T, typename Dim, const scale_source &Source, typename Static>
+	class quantity< T, unit<Dim, dynamic_scale<Source, Static>> >
+	{
+		T val;
+
+		using unit_type = dimensional::unit<Dim, dynamic_scale<Source, Static>>;
+
+	public:
+		constexpr quantity() = default;
+		explicit constexpr quantity( const T &val )
+			noexcept(std::is_nothrow_copy_constructible<T>::value)
+			: val(val) {}
+		explicit constexpr quantity( T &&val )
+			noexcept(std::is_nothrow_move_constructible<T>::value)
+			: val(std::move(val)) {}
+
+		// integer counts rounded as per the mode, if given
+		template<typename TR, typename DimR, typename ScaleR, typename Mode = rounding::toward_zero>
+		quantity( const quantity<TR, dimensional::unit<DimR, ScaleR>> &rhs, Mode mode = {} )
+			noexcept(noexcept( impl::scaled_by<T>( std::declval<const TR &>(), 0., mode ) ))
+			: val( impl::scaled_by<T>( rhs.count(),
+				impl::cached_ratio< ScaleR, dynamic_scale<Source, Static> >(), mode ) )
+		{
+			static_assert( DimR{} == Dim{},
+				"converting from quantity with different dimension" );
+		}
+
+		template<intmax_t Num, intmax_t Den, typename Mode = rounding::toward_zero>
+		auto to( constant<Num, Den> c, Mode mode = {} ) const
+			noexcept(noexcept( std::declval<const quantity &>().to( c * unit_of(Dim{}), mode ) ))
+		{ return to( c * unit_of(dimension), mode ); }
+		template<typename ToDim, typename ToScale, typename Mode = rounding::toward_zero>
+		auto to( dimensional::unit<ToDim, ToScale>, Mode mode = {} ) const
+			noexcept(noexcept( quantity<T, dimensional::unit<ToDim, ToScale>>{
+				impl::scaled_by<T>( std::declval<const T &>(), 0., mode ) } ))
+		{
+			static_assert( ToDim{} == Dim{},
+				"converting quantity to unit with different dimension" );
+			return quantity<T, dimensional::unit<ToDim, ToScale>>{ impl::scaled_by<T>( val,
+				impl::cached_ratio< dynamic_scale<Source, Static>, ToScale >(), mode ) };
+		}
+
+		constexpr const auto &count() const & noexcept { return val; }
+		constexpr T &&count() && noexcept { return std::move(val); }
+
+		static constexpr meta::type<T> type{};
+		static constexpr unit_type unit{};
+		static constexpr auto dimension = unit.dimension;
+		static constexpr auto scale = unit.scale;
+	};
+}
+
+#endif
@@ -0,0 +1,292 @@
+// lazy element-wise arithmetic on quantity spans and vectors:
+// u + a*t builds no temporaries, and is evaluated in a single fused loop
+
+#ifndef DIMENSIONAL_EXPRESSION_H
+#define DIMENSIONAL_EXPRESSION_H
+
+#include "bulk.hpp"
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+namespace dimensional
+{
+	template<typename Node>
+	class quantity_expression;
+
+
+	//   The nodes of an expression tree. at( i, s ) gives the i-th value of a
+	// node in its own unit, times the compile-time factor s. Nodes push the
+	// factors down to the operands, so that each operand ends up scaled once,
+	// by a single constant: the product of all the factors above it.
+	//   Integer trees only take integral factors through sums and products,
+	// which gives the same values as element-wise quantity arithmetic; the
+	// rest is applied where it arises, as quantity::to would.
+	namespace impl
+	{
+		using one = constant<1>;
+
+		template<typename S>
+		using integral_factor = std::integral_constant< bool, decltype(S::den)::value == 1 >;
+
+		// x*s, the way quantity::to scales
+		template<typename T, intmax_t Num, intmax_t Den>
+		inline constexpr T scaled( const T &x, constant<Num,Den> )
+		{
+			return Num == 1 && Den == 1 ? x : T( scale_count<Num, Den>( x ) );
+		}
+
+		// raw values of a span or vector
+		template<typename T, typename Unit>
+		struct leaf
+		{
+			const T *p;
+			std::size_t n;
+
+			using value_type = T;
+			using unit_type = Unit;
+			static constexpr bool broadcast = false;
+			static constexpr bool floating = std::is_floating_point<T>::value;
+
+			constexpr std::size_t size() const { return n; }
+			template<typename S>
+			constexpr T at( std::size_t i, S s ) const { return scaled( p[i], s ); }
+		};
+
+		// a quantity or plain number, taken for every element
+		template<typename T, typename Unit>
+		struct broadcast_leaf
+		{
+			T val;
+
+			using value_type = T;
+			using unit_type = Unit;
+			static constexpr bool broadcast = true;
+			static constexpr bool floating = std::is_floating_point<T>::value;
+
+			constexpr std::size_t size() const { return 0; }
+			template<typename S>
+			constexpr T at( std::size_t, S s ) const { return scaled( val, s ); }
+		};
+
+		template<typename Op, typename L, typename R>
+		struct binary_node
+		{
+			L l;
+			R r;
+
+			using value_type = decltype( std::declval<Op>()(
+				std::declval<typename L::value_type>(), std::declval<typename R::value_type>() ) );
+			static constexpr bool broadcast = L::broadcast && R::broadcast;
+			static constexpr bool floating = L::floating && R::floating;
+
+			constexpr binary_node( const L &l, const R &r ) : l(l), r(r) {}
+
+			constexpr std::size_t size() const { return L::broadcast ? r.size() : l.size(); }
+		};
+
+		// a + b, a - b: both brought to their common scale, as by heterop
+		template<typename Op, typename L, typename R>
+		struct sum_node : binary_node<Op, L, R>
+		{
+			using base = binary_node<Op, L, R>;
+			using base::base;
+			using typename base::value_type;
+			using unit_type = common_unit< typename L::unit_type, typename R::unit_type >;
+			using common = common_scale<
+				std::decay_t<decltype(L::unit_type::scale)>,
+				std::decay_t<decltype(R::unit_type::scale)> >;
+			using a_scale = constant< common::a_scale::value >;
+			using b_scale = constant< common::b_scale::value >;
+
+			static_assert( L::unit_type::dimension == R::unit_type::dimension,
+				"operating on quantities with different dimensions" );
+
+			template<typename S>
+			constexpr value_type at( std::size_t i, S s ) const
+			{ return at( i, s, std::integral_constant< bool, base::floating || integral_factor<S>::value >{} ); }
+
+		private:
+			template<typename S>
+			constexpr value_type at( std::size_t i, S, std::true_type ) const
+			{
+				using sa = decltype( S{} * a_scale{} );
+				using sb = decltype( S{} * b_scale{} );
+				return Op{}( this->l.at( i, sa{} ), this->r.at( i, sb{} ) );
+			}
+			template<typename S>
+			constexpr value_type at( std::size_t i, S s, std::false_type ) const
+			{ return scaled( at( i, one{}, std::true_type{} ), s ); }
+		};
+
+		// a * b, a / b: the factor goes to the left operand only
+		// (through a division, only for floating point)
+		template<typename Op, typename L, typename R>
+		struct product_node : binary_node<Op, L, R>
+		{
+			using base = binary_node<Op, L, R>;
+			using base::base;
+			using typename base::value_type;
+			using unit_type = std::decay_t< decltype( std::declval<Op>()(
+				typename L::unit_type{}, typename R::unit_type{} ) ) >;
+
+			static constexpr bool divides =
+				std::is_same< Op, std::decay_t<decltype(mjk::divides)> >::value;
+
+			template<typename S>
+			constexpr value_type at( std::size_t i, S s ) const
+			{
+				return at( i, s, std::integral_constant< bool,
+					base::floating || (!divides && integral_factor<S>::value) >{} );
+			}
+
+		private:
+			template<typename S>
+			constexpr value_type at( std::size_t i, S s, std::true_type ) const
+			{ return Op{}( this->l.at( i, s ), this->r.at( i, one{} ) ); }
+			template<typename S>
+			constexpr value_type at( std::size_t i, S s, std::false_type ) const
+			{ return scaled( at( i, one{}, std::true_type{} ), s ); }
+		};
+
+
+		// spans, vectors and expressions: what makes an operation lazy
+		template<typename T>
+		struct is_lazy : std::false_type {};
+		template<typename T, typename Unit>
+		struct is_lazy< quantity_span<T, Unit> > : std::true_type {};
+		template<typename T, typename Unit, typename Allocator>
+		struct is_lazy< quantity_vector<T, Unit, Allocator> > : std::true_type {};
+		template<typename Node>
+		struct is_lazy< quantity_expression<Node> > : std::true_type {};
+
+		template<typename T>
+		struct is_lazy_operand : std::integral_constant< bool,
+			is_lazy<T>::value || is_quantity<T>::value || std::is_arithmetic<T>::value >
+		{};
+
+		template<typename L, typename R>
+		using enable_lazy = std::enable_if_t<
+			(is_lazy<L>::value || is_lazy<R>::value) &&
+			is_lazy_operand<L>::value && is_lazy_operand<R>::value >;
+		// quantities on either side of * and / are left to the overloads
+		// spelled out for each kind of lazy operand, below
+		template<typename L, typename R>
+		using enable_lazy_product = std::enable_if_t<
+			!is_quantity<L>::value && !is_quantity<R>::value, enable_lazy<L, R> >;
+
+		template<typename T, typename Unit>
+		inline constexpr auto operand( quantity_span<T, Unit> s )
+		{ return leaf< std::remove_const_t<T>, Unit >{ s.data(), s.size() }; }
+		template<typename T, typename Unit, typename Allocator>
+		inline auto operand( const quantity_vector<T, Unit, Allocator> &v )
+		{ return leaf<T, Unit>{ v.data(), v.size() }; }
+		template<typename Node>
+		inline constexpr Node operand( const quantity_expression<Node> &e )
+		{ return e.node(); }
+		template<typename T, typename Unit>
+		inline constexpr auto operand( const quantity<T, Unit> &q )
+		{ return broadcast_leaf<T, Unit>{ q.count() }; }
+		template<typename T, typename = std::enable_if_t< std::is_arithmetic<T>::value >>
+		inline constexpr auto operand( const T &x )
+		{ return broadcast_leaf< T, std::decay_t<decltype(unitless)> >{ x }; }
+
+		template<template<typename...> class Node, typename Op, typename L, typename R>
+		inline auto lazy( Op, const L &l, const R &r )
+		{
+			using node = Node< Op, decltype(operand(l)), decltype(operand(r)) >;
+			const node n{ operand(l), operand(r) };
+			assert( n.l.broadcast || n.r.broadcast || n.l.size() == n.r.size() );
+			return quantity_expression<node>{ n };
+		}
+	}
+
+
+	// element-wise arithmetic, evaluated on assignment
+	// it refers to its operands: evaluate it before they go away
+	template<typename Node>
+	class quantity_expression
+	{
+		Node n;
+
+	public:
+		using node_type  = Node;
+		using value_type = quantity< typename Node::value_type, typename Node::unit_type >;
+
+		explicit constexpr quantity_expression( const Node &n ) : n(n) {}
+
+		constexpr const Node &node() const { return n; }
+		constexpr std::size_t size() const { return n.size(); }
+
+		constexpr value_type operator[]( std::size_t i ) const
+		{ return value_type{ n.at( i, impl::one{} ) }; }
+
+		static constexpr typename Node::unit_type unit{};
+		static constexpr auto dimension = unit.dimension;
+		static constexpr auto scale = unit.scale;
+	};
+
+
+	// dst[i] = e[i], converted to the unit and type of dst, for all i
+	// the conversion is folded into the operands' factors where exact;
+	// dst may be one of the operands, but not overlap one otherwise
+	template<typename T, typename Unit, typename Node>
+	inline void assign( quantity_span<T, Unit> dst, const quantity_expression<Node> &e )
+	{
+		static_assert( dst.dimension == quantity_expression<Node>::dimension,
+			"assigning quantities with different dimension" );
+		assert( dst.size() == e.size() );
+		using s = typename impl::rescale<
+			std::decay_t<decltype(e.scale)>, std::decay_t<decltype(dst.scale)> >::ratio;
+		const Node &n = e.node();
+		T *out = dst.data();
+		for ( std::size_t i = 0, size = dst.size(); i < size; ++i )
+			out[i] = T( n.at( i, s{} ) );
+	}
+
+	// the values of e, in its own unit and type
+	template<typename Node>
+	inline auto evaluate( const quantity_expression<Node> &e )
+	{
+		return quantity_vector< typename Node::value_type, typename Node::unit_type >( e );
+	}
+
+
+	template<typename L, typename R, typename = impl::enable_lazy<L, R>>
+	inline auto operator+( const L &l, const R &r )
+	{ return impl::lazy<impl::sum_node>( mjk::plus, l, r ); }
+	template<typename L, typename R, typename = impl::enable_lazy<L, R>>
+	inline auto operator-( const L &l, const R &r )
+	{ return impl::lazy<impl::sum_node>( mjk::minus, l, r ); }
+	template<typename L, typename R, typename = impl::enable_lazy_product<L, R>>
+	inline auto operator*( const L &l, const R &r )
+	{ return impl::lazy<impl::product_node>( mjk::multiplies, l, r ); }
+	template<typename L, typename R, typename = impl::enable_lazy_product<L, R>>
+	inline auto operator/( const L &l, const R &r )
+	{ return impl::lazy<impl::product_node>( mjk::divides, l, r ); }
+
+	// bulk * quant, quant * bulk, bulk / quant, quant / bulk
+	// (more specialized than quant * T and quant / T)
+	#define DIMENSIONAL_LAZY_ID( ... ) __VA_ARGS__
+	#define DIMENSIONAL_LAZY_QUANTITY_OPS( Bulk, ... ) \
+		template< __VA_ARGS__, typename TQ, typename UnitQ > \
+		inline auto operator*( const DIMENSIONAL_LAZY_ID Bulk &l, const quantity<TQ, UnitQ> &r ) \
+		{ return impl::lazy<impl::product_node>( mjk::multiplies, l, r ); } \
+		template< __VA_ARGS__, typename TQ, typename UnitQ > \
+		inline auto operator*( const quantity<TQ, UnitQ> &l, const DIMENSIONAL_LAZY_ID Bulk &r ) \
+		{ return impl::lazy<impl::product_node>( mjk::multiplies, l, r ); } \
+		template< __VA_ARGS__, typename TQ, typename UnitQ > \
+		inline auto operator/( const DIMENSIONAL_LAZY_ID Bulk &l, const quantity<TQ, UnitQ> &r ) \
+		{ return impl::lazy<impl::product_node>( mjk::divides, l, r ); } \
+		template< __VA_ARGS__, typename TQ, typename UnitQ > \
+		inline auto operator/( const quantity<TQ, UnitQ> &l, const DIMENSIONAL_LAZY_ID Bulk &r ) \
+		{ return impl::lazy<impl::product_node>( mjk::divides, l, r ); }
+	DIMENSIONAL_LAZY_QUANTITY_OPS( (quantity_span<T, Unit>), typename T, typename Unit )
+	DIMENSIONAL_LAZY_QUANTITY_OPS( (quantity_vector<T, Unit, Allocator>),
+		typename T, typename Unit, typename Allocator )
+	DIMENSIONAL_LAZY_QUANTITY_OPS( (quantity_expression<Node>), typename Node )
+	#undef DIMENSIONAL_LAZY_QUANTITY_OPS
+	#undef DIMENSIONAL_LAZY_ID
+}
+
+#endif
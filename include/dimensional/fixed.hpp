@@ -0,0 +1,165 @@
+// fixed-point data type: an integer count of 2^-FracBits, with the fraction
+// foldable into the unit scale and no floating point on the way
+
+#ifndef DIMENSIONAL_FIXED_H
+#define DIMENSIONAL_FIXED_H
+
+#include "dimensional.hpp"
+#include <limits>
+#include <type_traits>
+
+namespace dimensional
+{
+	//   Number with FracBits fractional bits, stored as the raw Int
+	// val*2^FracBits. Arithmetic is integer arithmetic on the raw values:
+	// products and quotients go through widened<Int> and are truncated
+	// toward zero, like the integer ones. Scaling by the compile-time
+	// factors of quantity conversions and heterop multiplies the raw value,
+	// or divides it (by shifts, for powers of two), just as for Int.
+	template<typename Int, int FracBits>
+	class fixed
+	{
+		static_assert( std::is_integral<Int>::value,
+			"fixed-point number of non-integer raw type" );
+		static_assert( FracBits >= 0 && FracBits < std::numeric_limits<Int>::digits,
+			"fixed-point number with no room for its fractional bits" );
+
+		Int val;
+
+		using wide = typename impl::widening_of<Int>::type;
+
+		template<typename I>
+		using if_integral = std::enable_if_t< std::is_integral<I>::value >;
+		template<typename F>
+		using if_floating = std::enable_if_t< std::is_floating_point<F>::value >;
+
+	public:
+		using rep = Int;
+		static constexpr int frac_bits = FracBits;
+
+		constexpr fixed() = default;
+		template<typename I, typename = if_integral<I>>
+		explicit constexpr fixed( I i ) noexcept
+			: val( impl::shift_up<FracBits>( static_cast<Int>( i ) ) ) {}
+		// the same number, in a raw type of another width
+		template<typename IntR>
+		explicit constexpr fixed( fixed<IntR, FracBits> o ) noexcept
+			: val( static_cast<Int>( o.raw() ) ) {}
+		// truncated toward zero, to the nearest 2^-FracBits
+		template<typename F, typename = if_floating<F>, typename = void>
+		explicit constexpr fixed( F f ) noexcept
+			: val( static_cast<Int>( f * impl::pow2<F>( FracBits ) ) ) {}
+
+		static constexpr fixed from_raw( Int raw ) noexcept
+		{
+			fixed res{};
+			res.val = raw;
+			return res;
+		}
+		constexpr Int raw() const noexcept { return val; }
+
+		// integral part, truncated toward zero
+		template<typename I, typename = if_integral<I>>
+		explicit constexpr operator I() const noexcept
+		{ return static_cast<I>( impl::shift_down<FracBits>( val ) ); }
+		template<typename F, typename = if_floating<F>, typename = void>
+		explicit constexpr operator F() const noexcept
+		{ return static_cast<F>( val ) * impl::pow2<F>( -FracBits ); }
+
+		constexpr fixed operator+() const noexcept { return *this; }
+		constexpr fixed operator-() const noexcept { return from_raw( static_cast<Int>( -val ) ); }
+
+		friend constexpr fixed operator+( fixed a, fixed b ) noexcept
+		{ return from_raw( static_cast<Int>( a.val + b.val ) ); }
+		friend constexpr fixed operator-( fixed a, fixed b ) noexcept
+		{ return from_raw( static_cast<Int>( a.val - b.val ) ); }
+		friend constexpr fixed operator*( fixed a, fixed b ) noexcept
+		{
+			return from_raw( static_cast<Int>(
+				impl::shift_down<FracBits>( static_cast<wide>( wide{a.val} * b.val ) ) ) );
+		}
+		friend constexpr fixed operator/( fixed a, fixed b ) noexcept
+		{
+			return from_raw( static_cast<Int>(
+				wide{a.val} * (wide{1} << FracBits) / b.val ) );
+		}
+
+		// by integers, without the round trip through fixed
+		template<typename I, typename = if_integral<I>>
+		friend constexpr fixed operator*( fixed a, I i ) noexcept
+		{ return from_raw( static_cast<Int>( a.val * i ) ); }
+		template<typename I, typename = if_integral<I>>
+		friend constexpr fixed operator*( I i, fixed a ) noexcept
+		{ return a * i; }
+		template<typename I, typename = if_integral<I>>
+		friend constexpr fixed operator/( fixed a, I i ) noexcept
+		{ return from_raw( static_cast<Int>( a.val / i ) ); }
+		template<typename I, typename = if_integral<I>>
+		friend constexpr fixed operator+( fixed a, I i ) noexcept { return a + fixed( i ); }
+		template<typename I, typename = if_integral<I>>
+		friend constexpr fixed operator+( I i, fixed a ) noexcept { return fixed( i ) + a; }
+		template<typename I, typename = if_integral<I>>
+		friend constexpr fixed operator-( fixed a, I i ) noexcept { return a - fixed( i ); }
+		template<typename I, typename = if_integral<I>>
+		friend constexpr fixed operator-( I i, fixed a ) noexcept { return fixed( i ) - a; }
+
+		// by the compile-time factors of unit conversion
+		template<intmax_t Num>
+		friend constexpr fixed operator*( fixed a, mjk::intmax_constant<Num> ) noexcept
+		{ return from_raw( static_cast<Int>( impl::scale_count<Num, 1>( a.val ) ) ); }
+		template<intmax_t Den>
+		friend constexpr fixed operator/( fixed a, mjk::intmax_constant<Den> ) noexcept
+		{ return from_raw( static_cast<Int>( impl::scale_count<1, Den>( a.val ) ) ); }
+
+		fixed &operator+=( fixed b ) noexcept { return *this = *this + b; }
+		fixed &operator-=( fixed b ) noexcept { return *this = *this - b; }
+		fixed &operator*=( fixed b ) noexcept { return *this = *this * b; }
+		fixed &operator/=( fixed b ) noexcept { return *this = *this / b; }
+
+		friend constexpr bool operator==( fixed a, fixed b ) noexcept { return a.val == b.val; }
+		friend constexpr bool operator!=( fixed a, fixed b ) noexcept { return a.val != b.val; }
+		friend constexpr bool operator< ( fixed a, fixed b ) noexcept { return a.val <  b.val; }
+		friend constexpr bool operator> ( fixed a, fixed b ) noexcept { return a.val >  b.val; }
+		friend constexpr bool operator<=( fixed a, fixed b ) noexcept { return a.val <= b.val; }
+		friend constexpr bool operator>=( fixed a, fixed b ) noexcept { return a.val >= b.val; }
+
+		template<typename I, typename = if_integral<I>>
+		friend constexpr bool operator==( fixed a, I i ) noexcept { return a == fixed( i ); }
+		template<typename I, typename = if_integral<I>>
+		friend constexpr bool operator==( I i, fixed a ) noexcept { return fixed( i ) == a; }
+		template<typename I, typename = if_integral<I>>
+		friend constexpr bool operator!=( fixed a, I i ) noexcept { return a != fixed( i ); }
+		template<typename I, typename = if_integral<I>>
+		friend constexpr bool operator!=( I i, fixed a ) noexcept { return fixed( i ) != a; }
+		template<typename I, typename = if_integral<I>>
+		friend constexpr bool operator<( fixed a, I i ) noexcept { return a < fixed( i ); }
+		template<typename I, typename = if_integral<I>>
+		friend constexpr bool operator<( I i, fixed a ) noexcept { return fixed( i ) < a; }
+		template<typename I, typename = if_integral<I>>
+		friend constexpr bool operator>( fixed a, I i ) noexcept { return a > fixed( i ); }
+		template<typename I, typename = if_integral<I>>
+		friend constexpr bool operator>( I i, fixed a ) noexcept { return fixed( i ) > a; }
+	};
+
+	// widening a fixed-point number widens its raw type
+	template<typename Int, int FracBits>
+	struct widened< fixed<Int, FracBits> >
+	{
+		using type = fixed< typename widened<Int>::type, FracBits >;
+	};
+
+
+	// the fixed-point quantity as its raw count, of 2^-FracBits of its unit;
+	// conversions of it to other units are then integer ones
+	template<typename Int, int FracBits, typename Unit>
+	inline constexpr auto raw_quantity( const quantity<fixed<Int, FracBits>, Unit> &q )
+	{ return q.count().raw() * (constant<1, (intmax_t{1} << FracBits)>{} * q.unit); }
+
+	// and the other way round: an integer quantity with FracBits of its
+	// count taken for the fraction, in the unit that's 2^FracBits times larger
+	template<int FracBits, typename Int, typename Unit>
+	inline constexpr auto fixed_quantity( const quantity<Int, Unit> &q )
+	{ return fixed<Int, FracBits>::from_raw( q.count() ) * (constant<(intmax_t{1} << FracBits)>{} * q.unit); }
+}
+
+#endif
@@ -0,0 +1,481 @@
+// formulas over run-time units, e.g. "distance / time" with distance in km
+// and time in h, compiled once: dimensions checked, scales folded into
+// constants, and the rest put as register code run over batches of records
+
+#ifndef DIMENSIONAL_FORMULA_H
+#define DIMENSIONAL_FORMULA_H
+
+#include "parse.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dimensional
+{
+	// thrown for strings that aren't formulas (those with dimensions that
+	// don't add up throw dimension_error, and ill units unit_parse_error)
+	struct formula_error : std::invalid_argument
+	{
+		using std::invalid_argument::invalid_argument;
+	};
+
+
+	namespace impl
+	{
+		//   One instruction: d = a op b, with k a constant folded in. Registers
+		// are numbered inputs first (the columns of the records), temporaries
+		// next, and the output last.
+		struct formula_instruction
+		{
+			enum op_type : std::uint8_t
+			{
+				add,        // a + b
+				sub,        // a - b
+				mul,        // a * b
+				div,        // a / b
+				add_scaled, // a + b*k
+				sub_scaled, // a - b*k
+				add_const,  // a + k
+				const_sub,  // k - a
+				const_div,  // k / a
+				scale,      // a * k
+				power,      // a ^ k
+				fill,       // k
+			};
+
+			op_type op;
+			std::uint16_t d, a, b;
+			double k;
+		};
+
+		inline double to_double( rational r ) noexcept
+		{ return double( r.num ) / double( r.den ); }
+
+		//   Recursive descent over
+		//     expr    = term { ("+" | "-") term }
+		//     term    = unary { ("*" | "/") unary }
+		//     unary   = "-" unary | factor
+		//     factor  = primary [ "^" power ]
+		//     primary = number [ "[" unit "]" ] | "[" unit "]" | name | "(" expr ")"
+		//     power   = ["-"] integer | "(" ["-"] integer ["/" integer] ")"
+		// emitting code as it goes. A value is either a constant, folded
+		// right away, or a register along with the scale its counts are in,
+		// which multiplications and divisions just fold in; only sums of
+		// different scales and the end result have the ratios applied.
+		class formula_compiler
+		{
+			struct value
+			{
+				bool constant;
+				double v;  // the constant in coherent units, or the register's scale
+				std::uint16_t reg;
+				dyn_dimension dimension;
+			};
+
+			const std::string &text;
+			const std::vector<std::pair<std::string, dyn_unit>> &variables;
+			std::size_t pos = 0;
+			std::vector<std::uint16_t> free_temps;
+
+		public:
+			std::vector<formula_instruction> code;
+			std::size_t temps = 0;
+
+		private:
+			[[noreturn]] void fail( const char *what ) const
+			{
+				throw formula_error{ std::string{ what } + " at " +
+					std::to_string( pos ) + " in formula \"" + text + "\"" };
+			}
+
+			static bool is_digit( char c ) { return c >= '0' && c <= '9'; }
+			static bool is_name( char c )
+			{ return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+
+			char peek()
+			{
+				while ( pos < text.size() && (text[pos] == ' ' || text[pos] == '\t') )
+					++pos;
+				return pos < text.size() ? text[pos] : '\0';
+			}
+			bool take( char c )
+			{
+				if ( peek() != c )
+					return false;
+				++pos;
+				return true;
+			}
+
+			std::uint16_t inputs() const
+			{ return static_cast<std::uint16_t>( variables.size() ); }
+			std::uint16_t temp()
+			{
+				if ( !free_temps.empty() )
+				{
+					const std::uint16_t t = free_temps.back();
+					free_temps.pop_back();
+					return t;
+				}
+				if ( inputs() + temps + 1 > UINT16_MAX )
+					fail( "formula too big" );
+				return static_cast<std::uint16_t>( inputs() + temps++ );
+			}
+			void release( const value &x )
+			{
+				if ( !x.constant && x.reg >= inputs() &&
+				     std::find( free_temps.begin(), free_temps.end(), x.reg ) == free_temps.end() )
+					free_temps.push_back( x.reg );
+			}
+			value emit( formula_instruction::op_type op, const value &a, const value &b, double k,
+				double scale, const dyn_dimension &dimension )
+			{
+				release( a );
+				release( b );
+				const std::uint16_t d = temp();
+				code.push_back( { op, d, a.constant ? d : a.reg, b.constant ? d : b.reg, k } );
+				return { false, scale, d, dimension };
+			}
+			static value constant( double v, const dyn_dimension &dimension = {} )
+			{ return { true, v, 0, dimension }; }
+			// x, with a scale of 0 or beyond double (of "x*0", say) applied to
+			// the counts right away, for sums not to divide by it
+			value settled( const value &x )
+			{
+				if ( x.constant || (std::isfinite( x.v ) && x.v != 0) )
+					return x;
+				return emit( formula_instruction::scale, x, x, x.v, 1, x.dimension );
+			}
+
+			void same_dimension( const value &a, const value &b ) const
+			{
+				if ( a.dimension != b.dimension )
+					throw dimension_error{ "adding different dimensions at " +
+						std::to_string( pos ) + " in formula \"" + text + "\"" };
+			}
+			value sum( const value &a, const value &b, bool minus )
+			{
+				same_dimension( a, b );
+				const double sign = minus ? -1 : 1;
+				if ( a.constant && b.constant )
+					return constant( a.v + sign*b.v, a.dimension );
+				if ( b.constant )
+					return emit( formula_instruction::add_const, a, a, sign*b.v/a.v, a.v, a.dimension );
+				if ( a.constant )
+					return minus ?
+						emit( formula_instruction::const_sub, b, b, a.v/b.v, b.v, a.dimension ) :
+						emit( formula_instruction::add_const, b, b, a.v/b.v, b.v, a.dimension );
+				if ( a.v == b.v )
+					return emit( minus ? formula_instruction::sub : formula_instruction::add,
+						a, b, 0, a.v, a.dimension );
+				return emit( minus ? formula_instruction::sub_scaled : formula_instruction::add_scaled,
+					a, b, b.v/a.v, a.v, a.dimension );
+			}
+			value product( value a, value b, bool quotient )
+			{
+				const dyn_dimension dim = quotient ? a.dimension / b.dimension : a.dimension * b.dimension;
+				if ( a.constant && b.constant )
+					return constant( quotient ? a.v/b.v : a.v*b.v, dim );
+				if ( b.constant )
+					return settled( { false, quotient ? a.v/b.v : a.v*b.v, a.reg, dim } );
+				if ( a.constant && !quotient )
+					return settled( { false, a.v*b.v, b.reg, dim } );
+				if ( a.constant )
+					return settled( emit( formula_instruction::const_div, b, b, 1, a.v/b.v, dim ) );
+				return settled( emit( quotient ? formula_instruction::div : formula_instruction::mul,
+					a, b, 0, quotient ? a.v/b.v : a.v*b.v, dim ) );
+			}
+
+			std::intmax_t integer()
+			{
+				if ( !is_digit( peek() ) )
+					fail( "integer expected" );
+				std::intmax_t n = 0;
+				for ( ; pos < text.size() && is_digit( text[pos] ); ++pos )
+					if ( __builtin_mul_overflow( n, 10, &n ) ||
+					     __builtin_add_overflow( n, text[pos] - '0', &n ) )
+						fail( "number out of range" );
+				return n;
+			}
+			rational power()
+			{
+				const bool group = take( '(' );
+				const bool negative = take( '-' );
+				std::intmax_t num = integer(), den = 1;
+				if ( group && take( '/' ) )
+					den = integer();
+				if ( group && !take( ')' ) )
+					fail( "')' expected" );
+				if ( den == 0 )
+					fail( "zero denominator" );
+				return { negative ? -num : num, den };
+			}
+			value unit_literal()
+			{
+				const std::size_t end = text.find( ']', pos );
+				if ( end == std::string::npos )
+					fail( "']' expected" );
+				const dyn_unit u = parse_unit( text.substr( pos, end - pos ) );
+				pos = end + 1;
+				return constant( to_double( u.scale ), u.dimension );
+			}
+			value primary()
+			{
+				const char c = peek();
+				if ( is_digit( c ) || c == '.' )
+				{
+					const char *begin = text.c_str() + pos;
+					char *end;
+					const double v = std::strtod( begin, &end );
+					if ( end == begin )
+						fail( "number expected" );
+					pos += static_cast<std::size_t>( end - begin );
+					return take( '[' ) ? product( constant( v ), unit_literal(), false ) : constant( v );
+				}
+				if ( take( '[' ) )
+					return unit_literal();
+				if ( is_name( c ) )
+				{
+					const std::size_t start = pos;
+					while ( pos < text.size() && (is_name( text[pos] ) || is_digit( text[pos] )) )
+						++pos;
+					const std::string name = text.substr( start, pos - start );
+					for ( std::size_t i = 0; i < variables.size(); ++i )
+						if ( variables[i].first == name )
+							return { false, to_double( variables[i].second.scale ),
+								static_cast<std::uint16_t>( i ), variables[i].second.dimension };
+					pos = start;
+					fail( "unknown variable" );
+				}
+				if ( !take( '(' ) )
+					fail( "operand expected" );
+				const value res = expr();
+				if ( !take( ')' ) )
+					fail( "')' expected" );
+				return res;
+			}
+			value factor()
+			{
+				value base = primary();
+				if ( !take( '^' ) )
+					return base;
+				const rational p = power();
+				dyn_dimension dim;
+				try
+				{
+					dim = base.dimension.pow( p );
+				}
+				catch ( const std::range_error & )
+				{
+					fail( "power not representable" );
+				}
+				const double k = to_double( p );
+				if ( base.constant )
+					return constant( std::pow( base.v, k ), dim );
+				// roots of a negative scale aren't real: apply it first
+				if ( p.den != 1 && base.v < 0 )
+					base = emit( formula_instruction::scale, base, base, base.v, 1, base.dimension );
+				if ( p == rational{ 2 } )
+					return settled( emit( formula_instruction::mul, base, base, 0, base.v*base.v, dim ) );
+				if ( p == rational{ -1 } )
+					return settled( emit( formula_instruction::const_div, base, base, 1, 1/base.v, dim ) );
+				return settled( emit( formula_instruction::power, base, base, k, std::pow( base.v, k ), dim ) );
+			}
+			value unary()
+			{
+				if ( !take( '-' ) )
+					return factor();
+				value res = unary();
+				res.v = -res.v;
+				return res;
+			}
+			value term()
+			{
+				value res = unary();
+				for ( ;; )
+					if ( take( '*' ) )
+						res = product( res, unary(), false );
+					else if ( take( '/' ) )
+						res = product( res, unary(), true );
+					else
+						return res;
+			}
+			value expr()
+			{
+				value res = term();
+				for ( ;; )
+					if ( take( '+' ) )
+						res = sum( res, term(), false );
+					else if ( take( '-' ) )
+						res = sum( res, term(), true );
+					else
+						return res;
+			}
+
+		public:
+			formula_compiler( const std::string &text,
+				const std::vector<std::pair<std::string, dyn_unit>> &variables )
+				: text(text), variables(variables) {}
+
+			// the code of the formula in unit u, its last instruction writing
+			// to the output register
+			void compile( const dyn_unit &u )
+			{
+				if ( variables.size() >= UINT16_MAX )
+					fail( "too many variables" );
+				const value res = expr();
+				if ( peek() != '\0' )
+					fail( "unexpected character" );
+				if ( res.dimension != u.dimension )
+					throw dimension_error{ "formula \"" + text + "\" isn't of the dimension asked for" };
+				const double ratio = res.v / to_double( u.scale );
+				const auto out = [&]{ return static_cast<std::uint16_t>( inputs() + temps ); };
+				if ( res.constant )
+					code.push_back( { formula_instruction::fill, out(), 0, 0, ratio } );
+				else if ( ratio == 1 && !code.empty() && code.back().d == res.reg )
+					code.back().d = out();
+				else
+					code.push_back( { formula_instruction::scale, out(), res.reg, res.reg, ratio } );
+			}
+		};
+	}
+
+
+	//   A formula of variables in run-time units, compiled for evaluating
+	// over many records, e.g.
+	//     const formula speed{ "distance / time",
+	//         { { "distance", parse_unit( "km" ) }, { "time", parse_unit( "h" ) } },
+	//         parse_unit( "m/s" ) };
+	//     speed.evaluate( columns, n, out );
+	// where columns[i] points to n values of the i-th variable, and out gets
+	// the n results, in m/s. Dimensions are checked at construction alone;
+	// the scales of the variables, of unit literals like "[km/h]", and of the
+	// result are folded into constants along the way, so that what's left
+	// is a few instructions on registers of whole blocks of records, each
+	// a plain loop the compiler can vectorize.
+	class formula
+	{
+		std::vector<impl::formula_instruction> code;
+		std::size_t inputs, temps;
+		dyn_unit result;
+
+	public:
+		using variable = std::pair<std::string, dyn_unit>;
+
+		formula( const std::string &text, const std::vector<variable> &variables,
+			const dyn_unit &result = {} )
+			: inputs( variables.size() ), result(result)
+		{
+			impl::formula_compiler c{ text, variables };
+			c.compile( result );
+			code = std::move(c.code);
+			temps = c.temps;
+		}
+
+		const dyn_unit &unit() const noexcept { return result; }
+		// the number of instructions run for each block of records
+		std::size_t size() const noexcept { return code.size(); }
+
+		void evaluate( const double *const *columns, std::size_t n, double *out ) const
+		{
+			constexpr std::size_t block = 256;
+			std::vector<double> scratch( temps * block );
+			std::vector<const double *> src( inputs + temps );
+			std::vector<double *> dst( temps + 1 );
+			for ( std::size_t t = 0; t < temps; ++t )
+				src[inputs + t] = dst[t] = scratch.data() + t * block;
+			for ( std::size_t at = 0; at < n; at += block )
+			{
+				const std::size_t m = std::min( block, n - at );
+				for ( std::size_t i = 0; i < inputs; ++i )
+					src[i] = columns[i] + at;
+				dst[temps] = out + at;
+				for ( const auto &in : code )
+					run( in, src.data(), dst.data(), m );
+			}
+		}
+
+		// a single record, the values of the variables in order, run one
+		// instruction at a time, the temporaries on the stack (for formulas
+		// of up to 32 of them, else allocated)
+		double operator()( const double *values ) const
+		{
+			constexpr std::size_t small = 32;
+			double local[small] = {};
+			std::vector<double> allocated;
+			double *t = local;
+			if ( temps + 1 > small )
+			{
+				allocated.resize( temps + 1 );
+				t = allocated.data();
+			}
+			for ( const auto &in : code )
+				t[in.d - inputs] = apply( in, values, t, inputs );
+			return t[temps];
+		}
+
+	private:
+		// dst is of the temporaries and the output, the registers from
+		// the inputs on
+		void run( const impl::formula_instruction &in,
+			const double *const *src, double *const *dst, std::size_t m ) const
+		{
+			using op = impl::formula_instruction;
+			double *const d = dst[in.d - inputs];
+			const double k = in.k;
+			if ( in.op == op::fill )
+			{
+				std::fill( d, d + m, k );
+				return;
+			}
+			const double *const a = src[in.a];
+			const double *const b = src[in.b];
+			switch ( in.op )
+			{
+			case op::add:        for ( std::size_t i = 0; i < m; ++i ) d[i] = a[i] + b[i];   break;
+			case op::sub:        for ( std::size_t i = 0; i < m; ++i ) d[i] = a[i] - b[i];   break;
+			case op::mul:        for ( std::size_t i = 0; i < m; ++i ) d[i] = a[i] * b[i];   break;
+			case op::div:        for ( std::size_t i = 0; i < m; ++i ) d[i] = a[i] / b[i];   break;
+			case op::add_scaled: for ( std::size_t i = 0; i < m; ++i ) d[i] = a[i] + b[i]*k; break;
+			case op::sub_scaled: for ( std::size_t i = 0; i < m; ++i ) d[i] = a[i] - b[i]*k; break;
+			case op::add_const:  for ( std::size_t i = 0; i < m; ++i ) d[i] = a[i] + k;      break;
+			case op::const_sub:  for ( std::size_t i = 0; i < m; ++i ) d[i] = k - a[i];      break;
+			case op::const_div:  for ( std::size_t i = 0; i < m; ++i ) d[i] = k / a[i];      break;
+			case op::scale:      for ( std::size_t i = 0; i < m; ++i ) d[i] = a[i] * k;      break;
+			case op::power:      for ( std::size_t i = 0; i < m; ++i ) d[i] = std::pow( a[i], k ); break;
+			case op::fill:       break;
+			}
+		}
+		// the same, of one record: the inputs, and the temporaries
+		static double apply( const impl::formula_instruction &in,
+			const double *values, const double *temps, std::size_t inputs )
+		{
+			using op = impl::formula_instruction;
+			const auto r = [&]( std::uint16_t i ){ return i < inputs ? values[i] : temps[i - inputs]; };
+			const double k = in.k;
+			switch ( in.op )
+			{
+			case op::add:        return r( in.a ) + r( in.b );
+			case op::sub:        return r( in.a ) - r( in.b );
+			case op::mul:        return r( in.a ) * r( in.b );
+			case op::div:        return r( in.a ) / r( in.b );
+			case op::add_scaled: return r( in.a ) + r( in.b )*k;
+			case op::sub_scaled: return r( in.a ) - r( in.b )*k;
+			case op::add_const:  return r( in.a ) + k;
+			case op::const_sub:  return k - r( in.a );
+			case op::const_div:  return k / r( in.a );
+			case op::scale:      return r( in.a ) * k;
+			case op::power:      return std::pow( r( in.a ), k );
+			case op::fill:       return k;
+			}
+			return k;
+		}
+	};
+}
+
+#endif
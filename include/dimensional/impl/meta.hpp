@@ -2,7 +2,9 @@
 #ifndef DIMENSIONAL_IMPL_META_H
 #define DIMENSIONAL_IMPL_META_H
 
+#include <cstddef>
 #include <type_traits>
+#include <utility>
 #include "mjk/integral_constant"
 
 namespace meta
@@ -76,6 +78,9 @@ namespace meta
 		sequence< bool_constant<(Values || true)>... >
 	>;
 
+	template<bool... Values>
+	using any = bool_constant< !all< !Values... >::value >;
+
 	inline constexpr auto not_(  true_type ) { return false_type{}; }
 	inline constexpr auto not_( false_type ) { return  true_type{}; }
 
@@ -105,31 +110,110 @@ namespace meta
 	{
 		namespace  impl
 		{
+			//   The algorithms below avoid head/tail recursion: predicates are
+			// expanded over the whole pack at once and the results aggregated
+			// with 'all'/'any' or turned into indices, so each call costs a
+			// constant number of class instantiations and no template depth.
+
+			template<typename T>
+			struct indexed_base
+			{
+				using type = T;
+			};
+			template<std::size_t I, typename T>
+			struct indexed : indexed_base<T> {};
+
+			template<typename Indices, typename... Ts>
+			struct indexer;
+			template<std::size_t... Is, typename... Ts>
+			struct indexer< std::index_sequence<Is...>, Ts... >
+				: indexed<Is,Ts>...
+			{};
+
+			template<std::size_t I, typename T>
+			indexed_base<T> select( const indexed<I,T> & );
+			// ^ for use in unevaluated contexts only
+
+			// I-th type of the pack, by overload resolution
+			// against a pack-wide (thus memoized) base
+			template<std::size_t I, typename... Ts>
+			using at = typename decltype( select<I>(
+				indexer< std::index_sequence_for<Ts...>, Ts... >{} ) )::type;
+
+
+			// index of the first true value, or the number of values
+			template<bool... Values>
+			inline constexpr std::size_t first_true()
+			{
+				const bool values[] = { Values..., true };
+				std::size_t i = 0;
+				while ( !values[i] )
+					++i;
+				return i;
+			}
+
+			template<std::size_t N>
+			struct index_array
+			{
+				std::size_t size;
+				std::size_t data[N ? N : 1];
+			};
+
+			// indices of the true values
+			template<bool... Values>
+			inline constexpr auto true_indices()
+			{
+				const bool values[] = { Values..., false };
+				index_array<sizeof...(Values)> res{};
+				for ( std::size_t i = 0; i < sizeof...(Values); ++i )
+					if ( values[i] )
+						res.data[res.size++] = i;
+				return res;
+			}
+
+			template<bool... Values>
+			struct true_indices_of
+			{
+				static constexpr index_array<sizeof...(Values)> value =
+					true_indices<Values...>();
+				using sequence = std::make_index_sequence< value.size >;
+			};
+			template<bool... Values>
+			constexpr index_array<sizeof...(Values)>
+				true_indices_of<Values...>::value;
+
+			// Seq of those Ts whose Keep value is true, order preserved
+			template<class Seq, typename Keep, typename Indices = typename Keep::sequence>
+			struct filter;
 			template
 			<
-				class Seq,
-				template<typename...> class Pred
+				template<typename...> class Seq,
+				typename... Ts,
+				typename Keep,
+				std::size_t... Is
 			>
-			struct contains;
+			struct filter< Seq<Ts...>, Keep, std::index_sequence<Is...> >
+			{
+				using type = Seq< at< Keep::value.data[Is], Ts... >... >;
+			};
+
 
 			template
 			<
-				template<typename...> class Seq,
-				typename Head, typename... Tail,
+				class Seq,
 				template<typename...> class Pred
 			>
-			struct contains< Seq<Head,Tail...>, Pred >
-			{
-				static constexpr bool value = Pred<Head>::value ||
-					contains<Seq<Tail...>,Pred>::value;
-			};
+			struct contains;
 
 			template
 			<
 				template<typename...> class Seq,
+				typename... Ts,
 				template<typename...> class Pred
 			>
-			struct contains< Seq<>, Pred > : false_type {};
+			struct contains< Seq<Ts...>, Pred >
+				: any< Pred<Ts>::value... >
+			{};
 
 
 			template<class Seq, typename T>
@@ -184,135 +268,103 @@ namespace meta
 			};
 
 
+			// number of Ts equivalent to T
 			template
 			<
-				class Seq,
-				template<typename...> class Compare
+				template<typename...> class Compare,
+				typename T, typename... Ts
 			>
-			struct is_uset;
+			inline constexpr std::size_t count()
+			{
+				const bool equiv[] = { Compare<T,Ts>::value..., false };
+				std::size_t n = 0;
+				for ( auto e : equiv )
+					n += e;
+				return n;
+			}
 
 			template
 			<
-				template<typename...> class Seq,
-				typename Head, typename... Tail,
-				template<typename...> class Pred
+				class Seq,
+				template<typename...> class Compare
 			>
-			struct is_uset< Seq<Head,Tail...>, Pred > : bool_constant<
-				!contains<Seq<Tail...>, is<Head>::template pred>::value &&
-					is_uset< Seq<Tail...>, Pred >::value
-			> {};
+			struct is_uset;
 
 			template
 			<
 				template<typename...> class Seq,
-				template<typename...> class Pred
+				typename... Ts,
+				template<typename...> class Compare
 			>
-			struct is_uset< Seq<>, Pred > : true_type {};  // empty sequence is always a set
+			struct is_uset< Seq<Ts...>, Compare > : bool_constant<
+				all< count<Compare, Ts, Ts...>() == 1 ... >::value
+			> {};  // empty sequence is always a set
 
 
-			template
-			<
-				class Seq,
-				template<typename...> class Pred,
-				bool Found = false,
-				typename FoundWhat = void
-			>
-			struct find_if;
-
-			template
-			<
-				template<typename...> class Seq,
-				typename Head, typename... Tail,
-				template<typename...> class Pred,
-				typename FoundWhat
-			>
-			struct find_if< Seq<Head,Tail...>, Pred, false, FoundWhat >
-				: find_if< Seq<Tail...>, Pred, Pred<Head>::value, Head > {};
+			template<class Seq, std::size_t I, bool Found>
+			struct found_at;
 
 			template
 			<
 				template<typename...> class Seq,
-				typename Head, typename... Tail,
-				template<typename...> class Pred,
-				typename FoundWhat
+				typename... Ts,
+				std::size_t I
 			>
-			struct find_if< Seq<Head,Tail...>, Pred, true, FoundWhat > : true_type
+			struct found_at< Seq<Ts...>, I, true > : true_type
 			{
-				using type = FoundWhat;
+				using type = at<I, Ts...>;
 				static constexpr auto tail_size =
-					size_constant< 1 + sizeof...(Tail) >{};
+					size_constant< sizeof...(Ts) - I - 1 >{};
 			};
 
 			template
 			<
 				template<typename...> class Seq,
-				template<typename...> class Pred,
-				bool Found,
-				typename FoundWhat
+				typename... Ts,
+				std::size_t I
 			>
-			struct find_if< Seq<>, Pred, Found, FoundWhat > : false_type
+			struct found_at< Seq<Ts...>, I, false > : false_type
 			{
 				static constexpr auto tail_size =
 					size_constant<0>{};
 			};
 
-
 			template
 			<
 				class Seq,
-				template<typename...> class Pred,
-				bool Found = true,
-				typename FoundWhat = void
+				template<typename...> class Pred
 			>
-			struct remove_if;
+			struct find_if;
 
 			template
 			<
 				template<typename...> class Seq,
-				typename Head, typename... Tail,
-				template<typename...> class Pred,
-				typename FoundWhat
+				typename... Ts,
+				template<typename...> class Pred
 			>
-			struct remove_if< Seq<Head,Tail...>, Pred, true, FoundWhat >
-				: remove_if< Seq<Tail...>, Pred, Pred<Head>::value, Head > {};
+			struct find_if< Seq<Ts...>, Pred > : found_at<
+				Seq<Ts...>,
+				first_true< Pred<Ts>::value... >(),
+				(first_true< Pred<Ts>::value... >() < sizeof...(Ts))
+			> {};
 
-			template
-			<
-				template<typename...> class Seq,
-				typename Head, typename... Tail,
-				template<typename...> class Pred,
-				typename FoundWhat
-			>
-			struct remove_if< Seq<Head,Tail...>, Pred, false, FoundWhat >
-			{
-				using type = typename prepend<
-					typename
-						remove_if< Seq<Tail...>, Pred, Pred<Head>::value, Head >
-					::type,
-					FoundWhat >::type;
-			};
 
 			template
 			<
-				template<typename...> class Seq,
-				template<typename...> class Pred,
-				typename FoundWhat
+				class Seq,
+				template<typename...> class Pred
 			>
-			struct remove_if< Seq<>, Pred, true, FoundWhat >
-			{
-				using type = Seq<>;
-			};
+			struct remove_if;
 
 			template
 			<
 				template<typename...> class Seq,
-				template<typename...> class Pred,
-				typename FoundWhat
+				typename... Ts,
+				template<typename...> class Pred
 			>
-			struct remove_if< Seq<>, Pred, false, FoundWhat >
-			{
-				using type = Seq<FoundWhat>;
-			};
+			struct remove_if< Seq<Ts...>, Pred >
+				: filter< Seq<Ts...>, true_indices_of< !Pred<Ts>::value... > >
+			{};
 
 			template
 			<
@@ -432,42 +484,100 @@ namespace meta
 				>;
 			};
 
+			using seq::impl::at;
+			using seq::impl::first_true;
+			using seq::impl::true_indices_of;
+			using seq::impl::filter;
+
+			// left fold of Assign over a sequence,
+			// only as deep as the number of equivalents
+			template<template<typename...> class Assign, class Seq>
+			struct assign_all;
+			template<template<typename...> class Assign, typename T>
+			struct assign_all< Assign, sequence<T> > : identity<T> {};
+			template
+			<
+				template<typename...> class Assign,
+				typename To, typename From, typename... Rest
+			>
+			struct assign_all< Assign, sequence<To, From, Rest...> >
+				: assign_all< Assign,
+					sequence< typename Assign<To,From>::type, Rest... > > {};
+
 			template
 			<
 				class Seq,
 				template<typename...> class Compare,
-				template<typename...> class Assign
+				template<typename...> class Assign,
+				typename Indices
 			>
-			struct make;
+			struct make_2;
 
 			template
 			<
 				template<typename...> class Seq,
-				typename Head, typename... Tail,
-				template<typename...> class Pred,
-				template<typename...> class Combine
+				typename... Ts,
+				template<typename...> class Compare,
+				template<typename...> class Assign,
+				std::size_t... Is
 			>
-			struct make< Seq<Head,Tail...>, Pred, Combine >
+			struct make_2< Seq<Ts...>, Compare, Assign, std::index_sequence<Is...> >
 			{
 			private:
-				using tailset = typename
-					make< Seq<Tail...>, Pred, Combine >
-				::type;
+				// whether the I-th element has no equivalent before it
+				template<std::size_t I>
+				using is_first = bool_constant<
+					first_true< Compare<Ts, at<I,Ts...>>::value... >() == I >;
+
+				// the I-th element with all its later equivalents assigned
+				// to it, in the same order as consecutive 'insert's would do
+				template<std::size_t I, typename Rev = std::index_sequence<
+					sizeof...(Ts)-1 - Is... > >
+				struct merged;
+				template<std::size_t I, std::size_t... Rs>
+				struct merged< I, std::index_sequence<Rs...> > : assign_all< Assign,
+					typename filter<
+						sequence< at<Rs,Ts...>... >,
+						true_indices_of<
+							Compare< at<Rs,Ts...>, at<I,Ts...> >::value... >
+					>::type
+				> {};
+
+				using firsts = true_indices_of< is_first<Is>::value... >;
+
+				template<typename Indices>
+				struct pick;
+				template<std::size_t... Fs>
+				struct pick< std::index_sequence<Fs...> >
+				{
+					using type = Seq< typename merged< firsts::value.data[Fs] >::type... >;
+				};
 			public:
-				using type = insert< tailset, Head, Pred, Combine >;
+				using type = typename pick< typename firsts::sequence >::type;
 			};
 
+			template
+			<
+				class Seq,
+				template<typename...> class Compare,
+				template<typename...> class Assign
+			>
+			struct make;
+
 			template
 			<
 				template<typename...> class Seq,
-				template<typename,typename> class Pred,
-				template<typename,typename> class Combine
+				typename... Ts,
+				template<typename...> class Compare,
+				template<typename...> class Assign
 			>
-			struct make< Seq<>, Pred, Combine>
-			{
-				using type = Seq<>;
-			};
+			struct make< Seq<Ts...>, Compare, Assign >
+				: make_2< Seq<Ts...>, Compare, Assign, std::index_sequence_for<Ts...> >
+			{};
+
 
+			template<typename... Ts>
+			struct inherit : Ts... {};
 
 			template<class SetA, class SetB>
 			struct equal;
@@ -479,9 +589,9 @@ namespace meta
 			>
 			struct equal< Set<A...>, Set<B...> > : bool_constant<
 				sizeof...(A) == sizeof...(B) &&
-				all< seq::contains< Set<B...>,
-					is<A>::template pred >::value...
-				>::value
+				all< std::is_base_of<
+					identity<A>, inherit< identity<B>... >
+				>::value... >::value
 			>
 			{
 			#ifdef VERYDEBUG
@@ -3,6 +3,7 @@
 #include "../meta"
 #include <cmath>
 #include <cstdint>
+#include <type_traits>
 #include <utility>
 
 namespace mjk
@@ -33,12 +34,26 @@ namespace mjk
 		return cbrt( root(std::forward<X>(x), intmax_constant<I/3>{}) );
 	}
 	template<typename X, std::intmax_t I>
-	inline constexpr auto root( X &&x, intmax_constant<I>,
+	inline auto root( X &&x, intmax_constant<I>,
 		int_if< (I > 0) and I % 3 and I % 2 > = 0 )
 	{
-		static_assert( !sizeof(x,0),
-			"not implemented" );
-		// TODO: something to the effect of  sign(x) * pow( abs(x), 1/n )
+		using T = std::decay_t<X>;
+		static_assert( std::is_floating_point<T>::value,
+			"not implemented for non-floating-point types" );
+		// odd, so the sign just carries over
+		using std::pow;
+		const T a = x < 0 ? -x : x;
+		T y = pow( a, T{1}/I );
+		// one Newton step to get exact roots right where pow is off by an ulp,
+		// unless y is infinite or its powers overflow or underflow
+		using std::isfinite;
+		if ( y > 0 and isfinite( y ) )
+		{
+			const T p = power<I>{}(y), d = I * power<I-1>{}(y);
+			if ( isfinite( p ) and isfinite( d ) and d > 0 )
+				y -= (p - a) / d;
+		}
+		return x < 0 ? -y : y;
 	}
 	template<typename X, std::intmax_t I>
 	inline constexpr auto root( X &&x, intmax_constant<I>,
@@ -6,6 +6,7 @@
 #include "mjk/fun"
 #include "mjk/integral_constant"
 #include "mjk/math"
+#include <cstddef>
 #include <cstdint>
 #include <ratio>
 
@@ -136,39 +137,74 @@ namespace meta
 	template<intmax_t NumA, intmax_t DenA, intmax_t NumB, intmax_t DenB>
 	inline constexpr auto operator< ( ratio<NumA,DenA> a, ratio<NumB,DenB> b )
 	{ return std::ratio_less < decltype(a), decltype(b) >{}; }
+	namespace impl
+	{
+		// base^exp <= x, for nonnegative x and base
+		inline constexpr bool power_at_most( intmax_t base, intmax_t exp, intmax_t x )
+		{
+			if ( base < 2 )
+				return base <= x;
+			intmax_t p = 1;
+			for ( ; exp; --exp )
+				if ( p > x / base )
+					return false;
+				else
+					p *= base;
+			return true;
+		}
+
+		// floor of the n-th root of nonnegative x, exactly
+		inline constexpr intmax_t iroot( intmax_t x, intmax_t n )
+		{
+			if ( x < 2 || n == 1 )
+				return x;
+			intmax_t lo = 1, hi = 2;
+			while ( hi < x && power_at_most(hi, n, x) )
+				lo = hi, hi = hi > INTMAX_MAX/2 ? INTMAX_MAX : hi*2;
+			// lo^n <= x < hi^n
+			while ( hi - lo > 1 )
+			{
+				const intmax_t mid = lo + (hi - lo)/2;
+				(power_at_most(mid, n, x) ? lo : hi) = mid;
+			}
+			return lo;
+		}
+
+		// n-th root of the ratio, which must be exact
+		template<intmax_t N, intmax_t Num, intmax_t Den>
+		inline constexpr auto root( ratio<Num,Den> )
+		{
+			static_assert( N > 0, "bad root index" );
+			static_assert( Num >= 0 || N % 2,
+				"even root of a negative ratio" );
+			using result = ratio
+			<
+				sign(Num) * iroot( abs(Num), N ),
+				iroot( Den, N )
+			>;
+			static_assert( mjk::pow(result{}, intmax_constant<N>{}) == ratio<Num,Den>{},
+				"inexact root" );
+			return result{};
+		}
+	}
+
 	// sqrt(ratio)
 	template<intmax_t Num, intmax_t Den>
-	inline constexpr auto sqrt( ratio<Num,Den> )
+	inline constexpr auto sqrt( ratio<Num,Den> r )
 	{
-		using LD = long double;
-		using root = ratio
-		<
-			static_cast<intmax_t>(std::sqrt( LD{Num} )),
-			static_cast<intmax_t>(std::sqrt( LD{Den} ))
-		>;
-		static_assert( mjk::square(root{}) == ratio<Num,Den>{},
-			"inexact square root" );
-		return root{};
+		return impl::root<2>( r );
 	}
 	// cbrt(ratio)
 	template<intmax_t Num, intmax_t Den>
-	inline constexpr auto cbrt( ratio<Num,Den> )
+	inline constexpr auto cbrt( ratio<Num,Den> r )
 	{
-		using LD = long double;
-		using root = ratio
-		<
-			static_cast<intmax_t>(std::cbrt( LD{Num} )),
-			static_cast<intmax_t>(std::cbrt( LD{Den} ))
-		>;
-		static_assert( mjk::cube(root{}) == ratio<Num,Den>{},
-			"inexact cube root" );
-		return root{};
+		return impl::root<3>( r );
 	}
 	// pow(ratio, ratio)
 	template<intmax_t NumA, intmax_t DenA, intmax_t NumB, intmax_t DenB>
 	inline constexpr auto pow( ratio<NumA,DenA> b, ratio<NumB,DenB> n )
 	{
-		return mjk::root( mjk::pow(b, n.num), n.den );
+		return impl::root<DenB>( mjk::pow(b, n.num) );
 	}
 	// root(ratio, ratio)
 	template<intmax_t NumA, intmax_t DenA, intmax_t NumB, intmax_t DenB>
@@ -193,94 +229,152 @@ namespace meta
 
 	namespace impl
 	{
+		//   Literals are parsed by a single constexpr function over their
+		// characters; the only type it materializes is the resulting
+		// rational_constant. Accepted are the integral forms (decimal, 0
+		// octal, 0x hexadecimal, 0b binary), fractions of decimal and octal
+		// ones, and exponents: decimal 'e' and hexadecimal-float 'p' (binary).
+
+		enum class literal_error
+		{
+			none,
+			digit_out_of_range,
+			octal_exponent,
+			overflow,
+		};
 
-		template<typename>
-		struct lower;
-		template<char c>
-		struct lower< char_constant<c> >
+		struct parsed_literal
 		{
-			using type = char_constant< (c >= 'A' && c <= 'Z') ? c+('a'-'A') : c >;
+			intmax_t num;
+			intmax_t den;
+			literal_error error;
 		};
 
-		template<typename Digit, typename Base>
-		constexpr auto parse_digit( Digit d, Base )
+		inline constexpr int digit_value( char c )
 		{
-			static_assert(
-				(Digit{} >= '0' && Digit{} <= '9') ||
-				(Digit{} >= 'a' && Digit{} < 'a'+Base{}-10),
-				// FIXME:                  ^  assuming signed overflow does not occur when reducing constant in comparison [-Wstrict-overflow]
-				"digit out of range" );
-			return ratio< (d <= '9') ? (d - '0') : (d - 'a' + 10) >{};
+			return
+				c >= '0' && c <= '9' ? c - '0' :
+				c >= 'a' && c <= 'z' ? c - 'a' + 10 :
+				c >= 'A' && c <= 'Z' ? c - 'A' + 10 :
+				-1;
 		}
 
-		template<typename... Digits, std::size_t... Powers, typename Base>
-		constexpr auto parse_digits_2
-		(
-			sequence< Digits... >,
-			std::index_sequence< Powers... >,
-			Base base
-		)
+		// acc = acc*base + digit, unless that overflows
+		inline constexpr bool shift_in( intmax_t &acc, intmax_t base, intmax_t digit )
 		{
-			return (void)base, mjk::sum
-			(
-				ratio<>{},
-				( parse_digit(Digits{}, base) * mjk::power<Powers>{}(base) )...
-			);
+			if ( acc > (INTMAX_MAX - digit) / base )
+				return false;
+			acc = acc*base + digit;
+			return true;
 		}
-		template<unsigned Base, typename... Digits>
-		constexpr auto parse_digits( sequence<Digits...> dig )
+
+		inline constexpr bool is_exp_mark( char c, char mark )
 		{
-			return parse_digits_2( dig,
-				mjk::make_integer_range< std::size_t, sizeof...(Digits), 0 >{},
-				ratio<Base>{} );
+			return c == mark || c == mark-'a'+'A';
 		}
 
-		template<unsigned Base, typename number>
-		constexpr auto parse_number( number )
+		template<std::size_t N>
+		constexpr parsed_literal parse_literal( const char (&str)[N] )
 		{
-			static_assert(
-				!seq::find< number, char_constant<'p'> >::value &&
-				!seq::find< number, char_constant<'e'> >::value,
-				"scientific format not supported yet" );
-			using dot = char_constant<'.'>;
-			using found  = seq::find  < number, dot >;
-			using digits = seq::remove< number, dot >;
-			return
-				parse_digits<Base>( digits{} ) /
-				mjk::pow( ratio<Base>{}, found::tail_size );
+			using error = literal_error;
+			constexpr parsed_literal zero{ 0, 1, error::none };
+
+			std::size_t i = 0;
+			intmax_t base = 10;
+			char exp_mark = 'e';
+			intmax_t exp_base = 10;
+			if ( N > 1 && str[0] == '0' )
+			{
+				const char prefix = str[1];
+				if ( prefix == 'x' || prefix == 'X' )
+					i = 2, base = 16, exp_mark = 'p', exp_base = 2;
+				else if ( prefix == 'b' || prefix == 'B' )
+					i = 2, base = 2;
+				else if ( prefix != '.' && !is_exp_mark(prefix, exp_mark) )
+					i = 1, base = 8;
+			}
+
+			intmax_t num = 0, den = 1;
+			// trailing zeroes of the fraction don't count, so that they
+			// cannot overflow the denominator
+			intmax_t pending_zeroes = 0;
+			bool fraction = false;
+			for ( ; i < N && !is_exp_mark(str[i], exp_mark); ++i )
+			{
+				const char c = str[i];
+				if ( c == '\'' )
+					continue;
+				if ( c == '.' )
+				{
+					fraction = true;
+					continue;
+				}
+				const int d = digit_value( c );
+				if ( d < 0 || d >= base )
+					return { 0, 1, error::digit_out_of_range };
+				if ( fraction && d == 0 )
+				{
+					++pending_zeroes;
+					continue;
+				}
+				for ( ; pending_zeroes; --pending_zeroes )
+					if ( !shift_in(num, base, 0) || !shift_in(den, base, 0) )
+						return { 0, 1, error::overflow };
+				if ( !shift_in(num, base, d) || (fraction && !shift_in(den, base, 0)) )
+					return { 0, 1, error::overflow };
+			}
+
+			if ( i == N )
+				return { num, den, error::none };
+			if ( base == 8 )
+				return { 0, 1, error::octal_exponent };
+
+			// exponent digits are always decimal
+			bool negative = false;
+			intmax_t exp = 0;
+			for ( ++i; i < N; ++i )
+			{
+				const char c = str[i];
+				if ( c == '-' || c == '+' )
+					negative = c == '-';
+				else if ( c != '\'' && !shift_in(exp, 10, c - '0') )
+					return { 0, 1, error::overflow };
+			}
+
+			if ( num == 0 )
+				return zero;
+			// cancel against the other side first, then grow this one
+			intmax_t &grown    = negative ? den : num;
+			intmax_t &shrunken = negative ? num : den;
+			for ( ; exp; --exp )
+				if ( shrunken % exp_base == 0 )
+					shrunken /= exp_base;
+				else if ( !shift_in(grown, exp_base, 0) )
+					return { 0, 1, error::overflow };
+			return { num, den, error::none };
 		}
 
-		template<typename Head, typename... Tail>
-		constexpr auto parse_literal_2( Head, sequence<Tail...> )
-		{ return parse_number<8>( sequence<Head,Tail...>{} ); }
-		template<typename Head, typename... Tail>
-		constexpr auto parse_literal_2( char_constant<'.'>, sequence<Head,Tail...> )
-		{ return parse_number<10>( sequence<char_constant<'.'>,Head,Tail...>{} ); }
-		template<typename Head, typename... Tail>
-		constexpr auto parse_literal_2( char_constant<'x'>, sequence<Head,Tail...> n )
-		{ return parse_number<16>( n ); }
-		template<typename Head, typename... Tail>
-		constexpr auto parse_literal_2( char_constant<'b'>, sequence<Head,Tail...> n )
-		{ return parse_number<2>( n ); }
-
-		template<typename Head, typename... Tail>
-		constexpr auto parse_literal( Head, sequence<Tail...> )
-		{ return parse_number<10>( sequence<Head,Tail...>{} ); }
-		template<typename Head, typename... Tail>
-		constexpr auto parse_literal( char_constant<'0'>, sequence<Head,Tail...> )
-		{ return parse_literal_2( Head{}, sequence<Tail...>{} ); }
-		constexpr auto parse_literal( char_constant<'0'>, sequence<> )
-		{ return ratio<>{}; }
+		template<char... Chars>
+		struct literal_chars
+		{
+			static constexpr char value[] = { Chars... };
+		};
+		template<char... Chars>
+		constexpr char literal_chars<Chars...>::value[];
 	}
 
-	template<char Head, char... Tail>
+	template<char... Chars>
 	constexpr auto parse_ratio()
 	{
-		using tail = sequence< char_constant<Tail>... >;
-		return impl::parse_literal(
-			char_constant<Head>{},
-			seq::transform< seq::remove<tail, char_constant<'\''>>, impl::lower>{}
-		);
+		using error = impl::literal_error;
+		constexpr auto r = impl::parse_literal( impl::literal_chars<Chars...>::value );
+		static_assert( r.error != error::digit_out_of_range,
+			"digit out of range" );
+		static_assert( r.error != error::octal_exponent,
+			"exponent on octal mantissa. drop the leading zero" );
+		static_assert( r.error != error::overflow,
+			"literal is not representable as rational_constant" );
+		return make_rational_constant< r.num, r.den >();
 	}
 
 
@@ -0,0 +1,602 @@
+
+#ifndef DIMENSIONAL_IMPL_SIMD_H
+#define DIMENSIONAL_IMPL_SIMD_H
+
+#include "mjk/fun"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if ( defined(__GNUC__) || defined(__clang__) ) && \
+    ( defined(__x86_64__) || defined(__i386__) )
+	#define DIMENSIONAL_SIMD_X86 1
+	#include <immintrin.h>
+	#define DIMENSIONAL_TARGET(isa) __attribute__(( target(isa) ))
+#else
+	#define DIMENSIONAL_SIMD_X86 0
+#endif
+
+
+//   Kernels rescaling arrays of raw values by a compile-time ratio, i.e. the
+// element-wise T(x*num/den) of quantity::to, chosen at run time by the
+// instruction sets the CPU supports. Every kernel gives the same values as
+// the scalar expression: floating-point values are multiplied and divided
+// just as well, and integer division is done as multiply-high and shift.
+// Each kernel returns how many leading elements it did; the rest is left
+// to the scalar loop.
+namespace dimensional { namespace impl { namespace simd
+{
+	enum class isa
+	{
+		scalar,
+		sse2,
+		avx2,
+		avx512, // F and DQ
+	};
+
+	inline isa detect()
+	{
+	#if DIMENSIONAL_SIMD_X86
+		__builtin_cpu_init();
+		if ( __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") )
+			return isa::avx512;
+		if ( __builtin_cpu_supports("avx2") )
+			return isa::avx2;
+		if ( __builtin_cpu_supports("sse2") )
+			return isa::sse2;
+	#endif
+		return isa::scalar;
+	}
+
+	// the best instruction set available, detected once
+	inline isa level()
+	{
+		static const isa best = detect();
+		return best;
+	}
+
+
+	// signed 32-bit division by a constant as multiply-high and shift
+	// ref: H. S. Warren, Jr., Hacker's Delight, 2nd ed., sec. 10-4
+	struct magic32
+	{
+		std::int32_t mul;
+		int shift;
+	};
+
+	// for 2 <= d < 2^31
+	inline constexpr magic32 magic_for( std::int32_t d )
+	{
+		using u32 = std::uint32_t;
+		const u32 two31 = u32{1} << 31;
+		const u32 ad  = static_cast<u32>( d );
+		const u32 anc = two31 - 1 - two31 % ad;
+		int p = 31;
+		u32 q1 = two31 / anc, r1 = two31 - q1*anc;
+		u32 q2 = two31 / ad,  r2 = two31 - q2*ad;
+		u32 delta = 0;
+		do
+		{
+			++p;
+			q1 *= 2; r1 *= 2;
+			if ( r1 >= anc ) ++q1, r1 -= anc;
+			q2 *= 2; r2 *= 2;
+			if ( r2 >= ad ) ++q2, r2 -= ad;
+			delta = ad - r2;
+		}
+		while ( q1 < delta || (q1 == delta && r1 == 0) );
+		return { static_cast<std::int32_t>( q2+1 ), p - 32 };
+	}
+
+	// n/D, truncated, as the vector kernels do it
+	template<std::int32_t D>
+	inline constexpr std::int32_t divide( std::int32_t n )
+	{
+		constexpr magic32 m = magic_for( D );
+		std::int32_t q = static_cast<std::int32_t>(
+			(std::int64_t{m.mul} * n) >> 32 );
+		if ( m.mul < 0 )
+			q += n;
+		return (q >> m.shift) + static_cast<std::int32_t>( static_cast<std::uint32_t>(n) >> 31 );
+	}
+
+
+	// k for d == 2^k, or -1
+	inline constexpr int log2_exact( std::intmax_t d )
+	{
+		int k = 0;
+		for ( ; d > 1 && d % 2 == 0; d /= 2 )
+			++k;
+		return d == 1 ? k : -1;
+	}
+
+
+	// no kernel for other types and ratios
+	template<std::intmax_t Num, std::intmax_t Den, typename T>
+	inline std::size_t rescale_sse2( const T *, std::size_t, T * ) { return 0; }
+	template<std::intmax_t Num, std::intmax_t Den, typename T>
+	inline std::size_t rescale_avx2( const T *, std::size_t, T * ) { return 0; }
+	template<std::intmax_t Num, std::intmax_t Den, typename T>
+	inline std::size_t rescale_avx512( const T *, std::size_t, T * ) { return 0; }
+
+#if DIMENSIONAL_SIMD_X86
+	// g++ 12 sees the _mm512_undefined_* within _mm512_set1_* as uninitialized
+	#pragma GCC diagnostic push
+	#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+	// float
+
+	template<std::intmax_t Num, std::intmax_t Den>
+	DIMENSIONAL_TARGET("sse2")
+	inline std::size_t rescale_sse2( const float *in, std::size_t n, float *out )
+	{
+		const __m128 num = _mm_set1_ps( static_cast<float>(Num) );
+		const __m128 den = _mm_set1_ps( static_cast<float>(Den) );
+		std::size_t i = 0;
+		for ( ; i + 4 <= n; i += 4 )
+		{
+			__m128 x = _mm_loadu_ps( in+i );
+			if ( Num != 1 ) x = _mm_mul_ps( x, num );
+			if ( Den != 1 ) x = _mm_div_ps( x, den );
+			_mm_storeu_ps( out+i, x );
+		}
+		return i;
+	}
+	template<std::intmax_t Num, std::intmax_t Den>
+	DIMENSIONAL_TARGET("avx2")
+	inline std::size_t rescale_avx2( const float *in, std::size_t n, float *out )
+	{
+		const __m256 num = _mm256_set1_ps( static_cast<float>(Num) );
+		const __m256 den = _mm256_set1_ps( static_cast<float>(Den) );
+		std::size_t i = 0;
+		for ( ; i + 8 <= n; i += 8 )
+		{
+			__m256 x = _mm256_loadu_ps( in+i );
+			if ( Num != 1 ) x = _mm256_mul_ps( x, num );
+			if ( Den != 1 ) x = _mm256_div_ps( x, den );
+			_mm256_storeu_ps( out+i, x );
+		}
+		return i;
+	}
+	template<std::intmax_t Num, std::intmax_t Den>
+	DIMENSIONAL_TARGET("avx512f,avx512dq")
+	inline std::size_t rescale_avx512( const float *in, std::size_t n, float *out )
+	{
+		const __m512 num = _mm512_set1_ps( static_cast<float>(Num) );
+		const __m512 den = _mm512_set1_ps( static_cast<float>(Den) );
+		std::size_t i = 0;
+		for ( ; i + 16 <= n; i += 16 )
+		{
+			__m512 x = _mm512_loadu_ps( in+i );
+			if ( Num != 1 ) x = _mm512_mul_ps( x, num );
+			if ( Den != 1 ) x = _mm512_div_ps( x, den );
+			_mm512_storeu_ps( out+i, x );
+		}
+		return i;
+	}
+
+	// double
+
+	template<std::intmax_t Num, std::intmax_t Den>
+	DIMENSIONAL_TARGET("sse2")
+	inline std::size_t rescale_sse2( const double *in, std::size_t n, double *out )
+	{
+		const __m128d num = _mm_set1_pd( static_cast<double>(Num) );
+		const __m128d den = _mm_set1_pd( static_cast<double>(Den) );
+		std::size_t i = 0;
+		for ( ; i + 2 <= n; i += 2 )
+		{
+			__m128d x = _mm_loadu_pd( in+i );
+			if ( Num != 1 ) x = _mm_mul_pd( x, num );
+			if ( Den != 1 ) x = _mm_div_pd( x, den );
+			_mm_storeu_pd( out+i, x );
+		}
+		return i;
+	}
+	template<std::intmax_t Num, std::intmax_t Den>
+	DIMENSIONAL_TARGET("avx2")
+	inline std::size_t rescale_avx2( const double *in, std::size_t n, double *out )
+	{
+		const __m256d num = _mm256_set1_pd( static_cast<double>(Num) );
+		const __m256d den = _mm256_set1_pd( static_cast<double>(Den) );
+		std::size_t i = 0;
+		for ( ; i + 4 <= n; i += 4 )
+		{
+			__m256d x = _mm256_loadu_pd( in+i );
+			if ( Num != 1 ) x = _mm256_mul_pd( x, num );
+			if ( Den != 1 ) x = _mm256_div_pd( x, den );
+			_mm256_storeu_pd( out+i, x );
+		}
+		return i;
+	}
+	template<std::intmax_t Num, std::intmax_t Den>
+	DIMENSIONAL_TARGET("avx512f,avx512dq")
+	inline std::size_t rescale_avx512( const double *in, std::size_t n, double *out )
+	{
+		const __m512d num = _mm512_set1_pd( static_cast<double>(Num) );
+		const __m512d den = _mm512_set1_pd( static_cast<double>(Den) );
+		std::size_t i = 0;
+		for ( ; i + 8 <= n; i += 8 )
+		{
+			__m512d x = _mm512_loadu_pd( in+i );
+			if ( Num != 1 ) x = _mm512_mul_pd( x, num );
+			if ( Den != 1 ) x = _mm512_div_pd( x, den );
+			_mm512_storeu_pd( out+i, x );
+		}
+		return i;
+	}
+
+	// int32: the product wraps like the scalar one truncated to 32 bits;
+	// division is by magic number, for 1/Den only
+
+	template<std::intmax_t Num, std::intmax_t Den>
+	DIMENSIONAL_TARGET("avx2")
+	inline std::size_t rescale_avx2( const std::int32_t *in, std::size_t n, std::int32_t *out )
+	{
+		std::size_t i = 0;
+		if ( Den == 1 )
+		{
+			const __m256i num = _mm256_set1_epi32( static_cast<std::int32_t>(Num) );
+			for ( ; i + 8 <= n; i += 8 )
+			{
+				const __m256i x = _mm256_loadu_si256( reinterpret_cast<const __m256i *>(in+i) );
+				_mm256_storeu_si256( reinterpret_cast<__m256i *>(out+i), _mm256_mullo_epi32(x, num) );
+			}
+		}
+		else if ( Num == 1 && Den <= INT32_MAX && log2_exact(Den) > 0 )
+		{
+			// biased toward zero, then shifted
+			constexpr int k = log2_exact( Den ) > 0 && Den <= INT32_MAX ? log2_exact( Den ) : 1;
+			for ( ; i + 8 <= n; i += 8 )
+			{
+				const __m256i x = _mm256_loadu_si256( reinterpret_cast<const __m256i *>(in+i) );
+				const __m256i bias = _mm256_srli_epi32( _mm256_srai_epi32(x, 31), 32-k );
+				_mm256_storeu_si256( reinterpret_cast<__m256i *>(out+i),
+					_mm256_srai_epi32( _mm256_add_epi32(x, bias), k ) );
+			}
+		}
+		else if ( Num == 1 && Den <= INT32_MAX )
+		{
+			constexpr magic32 m = magic_for( Den > 1 && Den <= INT32_MAX ?
+				static_cast<std::int32_t>(Den) : 2 );
+			const __m256i mul = _mm256_set1_epi32( m.mul );
+			for ( ; i + 8 <= n; i += 8 )
+			{
+				const __m256i x = _mm256_loadu_si256( reinterpret_cast<const __m256i *>(in+i) );
+				// high halves of the even and odd 32x32-bit products
+				const __m256i even = _mm256_mul_epi32( x, mul );
+				const __m256i odd  = _mm256_mul_epi32( _mm256_srli_epi64(x, 32), mul );
+				__m256i q = _mm256_blend_epi32( _mm256_srli_epi64(even, 32), odd, 0xAA );
+				if ( m.mul < 0 )
+					q = _mm256_add_epi32( q, x );
+				q = _mm256_srai_epi32( q, m.shift );
+				q = _mm256_add_epi32( q, _mm256_srli_epi32(x, 31) );
+				_mm256_storeu_si256( reinterpret_cast<__m256i *>(out+i), q );
+			}
+		}
+		return i;
+	}
+	template<std::intmax_t Num, std::intmax_t Den>
+	DIMENSIONAL_TARGET("avx512f,avx512dq")
+	inline std::size_t rescale_avx512( const std::int32_t *in, std::size_t n, std::int32_t *out )
+	{
+		std::size_t i = 0;
+		if ( Den == 1 )
+		{
+			const __m512i num = _mm512_set1_epi32( static_cast<std::int32_t>(Num) );
+			for ( ; i + 16 <= n; i += 16 )
+			{
+				const __m512i x = _mm512_loadu_si512( in+i );
+				_mm512_storeu_si512( out+i, _mm512_mullo_epi32(x, num) );
+			}
+		}
+		else if ( Num == 1 && Den <= INT32_MAX && log2_exact(Den) > 0 )
+		{
+			constexpr unsigned k = log2_exact( Den ) > 0 && Den <= INT32_MAX ?
+				static_cast<unsigned>( log2_exact( Den ) ) : 1;
+			for ( ; i + 16 <= n; i += 16 )
+			{
+				const __m512i x = _mm512_loadu_si512( in+i );
+				const __m512i bias = _mm512_srli_epi32( _mm512_srai_epi32(x, 31), 32-k );
+				_mm512_storeu_si512( out+i, _mm512_srai_epi32( _mm512_add_epi32(x, bias), k ) );
+			}
+		}
+		else if ( Num == 1 && Den <= INT32_MAX )
+		{
+			constexpr magic32 m = magic_for( Den > 1 && Den <= INT32_MAX ?
+				static_cast<std::int32_t>(Den) : 2 );
+			const __m512i mul = _mm512_set1_epi32( m.mul );
+			for ( ; i + 16 <= n; i += 16 )
+			{
+				const __m512i x = _mm512_loadu_si512( in+i );
+				const __m512i even = _mm512_mul_epi32( x, mul );
+				const __m512i odd  = _mm512_mul_epi32( _mm512_srli_epi64(x, 32), mul );
+				__m512i q = _mm512_mask_blend_epi32( 0xAAAA, _mm512_srli_epi64(even, 32), odd );
+				if ( m.mul < 0 )
+					q = _mm512_add_epi32( q, x );
+				q = _mm512_srai_epi32( q, static_cast<unsigned>(m.shift) );
+				q = _mm512_add_epi32( q, _mm512_srli_epi32(x, 31) );
+				_mm512_storeu_si512( out+i, q );
+			}
+		}
+		return i;
+	}
+
+	// int64: multiplication, and division by powers of two only; the compiler
+	// already divides the scalar way by multiply-high, which has no 64-bit
+	// vector counterpart
+
+	template<std::intmax_t Num, std::intmax_t Den>
+	DIMENSIONAL_TARGET("avx2")
+	inline std::size_t rescale_avx2( const std::int64_t *in, std::size_t n, std::int64_t *out )
+	{
+		std::size_t i = 0;
+		if ( Num == 1 && log2_exact(Den) > 0 )
+		{
+			// no 64-bit arithmetic shift: a logical one, with the sign put back
+			constexpr int k = log2_exact( Den ) > 0 ? log2_exact( Den ) : 1;
+			const __m256i zero = _mm256_setzero_si256();
+			for ( ; i + 4 <= n; i += 4 )
+			{
+				const __m256i x = _mm256_loadu_si256( reinterpret_cast<const __m256i *>(in+i) );
+				const __m256i y = _mm256_add_epi64( x,
+					_mm256_srli_epi64( _mm256_cmpgt_epi64(zero, x), 64-k ) );
+				_mm256_storeu_si256( reinterpret_cast<__m256i *>(out+i), _mm256_or_si256(
+					_mm256_srli_epi64( y, k ),
+					_mm256_slli_epi64( _mm256_cmpgt_epi64(zero, y), 64-k ) ) );
+			}
+			return i;
+		}
+		if ( Den != 1 )
+			return i;
+		const __m256i num    = _mm256_set1_epi64x( Num );
+		const __m256i num_hi = _mm256_srli_epi64( num, 32 );
+		for ( ; i + 4 <= n; i += 4 )
+		{
+			const __m256i x = _mm256_loadu_si256( reinterpret_cast<const __m256i *>(in+i) );
+			// low 64 bits of the product out of 32x32-bit ones
+			const __m256i lo    = _mm256_mul_epu32( x, num );
+			const __m256i cross = _mm256_add_epi64(
+				_mm256_mul_epu32( _mm256_srli_epi64(x, 32), num ),
+				_mm256_mul_epu32( x, num_hi ) );
+			_mm256_storeu_si256( reinterpret_cast<__m256i *>(out+i),
+				_mm256_add_epi64( lo, _mm256_slli_epi64(cross, 32) ) );
+		}
+		return i;
+	}
+	template<std::intmax_t Num, std::intmax_t Den>
+	DIMENSIONAL_TARGET("avx512f,avx512dq")
+	inline std::size_t rescale_avx512( const std::int64_t *in, std::size_t n, std::int64_t *out )
+	{
+		std::size_t i = 0;
+		if ( Num == 1 && log2_exact(Den) > 0 )
+		{
+			constexpr unsigned k = log2_exact( Den ) > 0 ? static_cast<unsigned>( log2_exact( Den ) ) : 1;
+			for ( ; i + 8 <= n; i += 8 )
+			{
+				const __m512i x = _mm512_loadu_si512( in+i );
+				const __m512i bias = _mm512_srli_epi64( _mm512_srai_epi64(x, 63), 64-k );
+				_mm512_storeu_si512( out+i, _mm512_srai_epi64( _mm512_add_epi64(x, bias), k ) );
+			}
+			return i;
+		}
+		if ( Den != 1 )
+			return i;
+		const __m512i num = _mm512_set1_epi64( Num );
+		for ( ; i + 8 <= n; i += 8 )
+		{
+			const __m512i x = _mm512_loadu_si512( in+i );
+			_mm512_storeu_si512( out+i, _mm512_mullo_epi64(x, num) );
+		}
+		return i;
+	}
+
+	#pragma GCC diagnostic pop
+#endif
+
+
+	// binary operations on both operands brought to a common scale, as by
+	// heterop_raw: out[i] = op( T(a[i]*ScaleA), T(b[i]*ScaleB) )
+	// written with GCC vector extensions, so that one kernel serves every
+	// lane type and width; the instruction set is that of the caller
+
+	template<typename T>
+	struct has_lanes : std::integral_constant< bool,
+		std::is_same<T, float>::value || std::is_same<T, double>::value ||
+		std::is_same<T, std::int32_t>::value || std::is_same<T, std::int64_t>::value >
+	{};
+
+	// the operations that the kernels spell out on whole vectors
+	// (calls passing vectors would cross into code for other instruction sets)
+	enum class lanes_op_code { none, plus, minus, less, equal_to };
+	template<typename Op>
+	struct lanes_op : std::integral_constant<lanes_op_code, lanes_op_code::none> {};
+	#define DIMENSIONAL_LANES_OP( name ) \
+		template<> \
+		struct lanes_op< std::decay_t<decltype(mjk::name)> > \
+			: std::integral_constant<lanes_op_code, lanes_op_code::name> {};
+	DIMENSIONAL_LANES_OP( plus )
+	DIMENSIONAL_LANES_OP( minus )
+	DIMENSIONAL_LANES_OP( less )
+	DIMENSIONAL_LANES_OP( equal_to )
+	#undef DIMENSIONAL_LANES_OP
+
+#if DIMENSIONAL_SIMD_X86
+	// each operand is rounded once scaled, as in the scalar loop,
+	// so no fusing into FMA where the target has it
+	#pragma GCC push_options
+	#pragma GCC optimize ("fp-contract=off")
+
+	template<typename T, std::size_t Bytes>
+	struct vector
+	{
+		typedef T type __attribute__(( vector_size(Bytes) ));
+	};
+
+	template<std::size_t Bytes, std::intmax_t ScaleA, std::intmax_t ScaleB,
+		typename Op, typename T, typename R>
+	__attribute__(( always_inline ))
+	inline std::size_t heterop_lanes( Op, const T *a, const T *b, std::size_t n, R *out )
+	{
+		using vec = typename vector<T, Bytes>::type;
+		constexpr std::size_t lanes = Bytes / sizeof(T);
+		// T(x*scale) of a 32-bit x wraps just like its 32-bit product
+		const T sa = static_cast<T>( ScaleA ), sb = static_cast<T>( ScaleB );
+		std::size_t i = 0;
+		for ( ; i + lanes <= n; i += lanes )
+		{
+			vec x, y;
+			__builtin_memcpy( &x, a+i, sizeof x );
+			__builtin_memcpy( &y, b+i, sizeof y );
+			if ( ScaleA != 1 ) x *= sa;
+			if ( ScaleB != 1 ) y *= sb;
+			// the comparisons are made lane by lane on the scaled vectors:
+			// whole-vector masks of 64-byte vectors trip up GCC 12
+			#define DIMENSIONAL_LANES_STORE( expr ) \
+				for ( std::size_t k = 0; k < lanes; ++k ) \
+					out[i+k] = static_cast<R>( expr );
+			switch ( lanes_op<Op>::value )
+			{
+				case lanes_op_code::plus:     DIMENSIONAL_LANES_STORE( (x + y)[k] ) break;
+				case lanes_op_code::minus:    DIMENSIONAL_LANES_STORE( (x - y)[k] ) break;
+				case lanes_op_code::less:     DIMENSIONAL_LANES_STORE( x[k] <  y[k] ) break;
+				case lanes_op_code::equal_to: DIMENSIONAL_LANES_STORE( x[k] == y[k] ) break;
+				case lanes_op_code::none:     break;
+			}
+			#undef DIMENSIONAL_LANES_STORE
+		}
+		return i;
+	}
+
+	template<std::intmax_t ScaleA, std::intmax_t ScaleB, typename Op, typename T, typename R>
+	DIMENSIONAL_TARGET("sse2")
+	inline std::size_t heterop_sse2( Op op, const T *a, const T *b, std::size_t n, R *out )
+	{ return heterop_lanes<16, ScaleA, ScaleB>( op, a, b, n, out ); }
+	template<std::intmax_t ScaleA, std::intmax_t ScaleB, typename Op, typename T, typename R>
+	DIMENSIONAL_TARGET("avx2")
+	inline std::size_t heterop_avx2( Op op, const T *a, const T *b, std::size_t n, R *out )
+	{ return heterop_lanes<32, ScaleA, ScaleB>( op, a, b, n, out ); }
+	template<std::intmax_t ScaleA, std::intmax_t ScaleB, typename Op, typename T, typename R>
+	DIMENSIONAL_TARGET("avx512f,avx512dq")
+	inline std::size_t heterop_avx512( Op op, const T *a, const T *b, std::size_t n, R *out )
+	{ return heterop_lanes<64, ScaleA, ScaleB>( op, a, b, n, out ); }
+
+	// compensated (Kahan) sums of in[i]*Mul/Div, one per lane, written to
+	// sums and comps (the low-order parts lost, negated) for the caller to
+	// fold; the scaling itself isn't compensated for
+	template<std::size_t Bytes, std::intmax_t Mul, std::intmax_t Div, typename T>
+	__attribute__(( always_inline ))
+	inline std::size_t kahan_lanes( const T *in, std::size_t n, T *sums, T *comps )
+	{
+		using vec = typename vector<T, Bytes>::type;
+		constexpr std::size_t lanes = Bytes / sizeof(T);
+		const T mul = static_cast<T>( Mul ), div = static_cast<T>( Div );
+		vec s{}, c{};
+		std::size_t i = 0;
+		for ( ; i + lanes <= n; i += lanes )
+		{
+			vec x;
+			__builtin_memcpy( &x, in+i, sizeof x );
+			if ( Mul != 1 ) x *= mul;
+			if ( Div != 1 ) x /= div;
+			const vec y = x - c;
+			const vec t = s + y;
+			c = (t - s) - y;
+			s = t;
+		}
+		for ( std::size_t k = 0; k < lanes; ++k )
+			sums[k] = s[k], comps[k] = c[k];
+		return i;
+	}
+
+	template<std::intmax_t Mul, std::intmax_t Div, typename T>
+	DIMENSIONAL_TARGET("sse2")
+	inline std::size_t kahan_sse2( const T *in, std::size_t n, T *sums, T *comps )
+	{ return kahan_lanes<16, Mul, Div>( in, n, sums, comps ); }
+	template<std::intmax_t Mul, std::intmax_t Div, typename T>
+	DIMENSIONAL_TARGET("avx2")
+	inline std::size_t kahan_avx2( const T *in, std::size_t n, T *sums, T *comps )
+	{ return kahan_lanes<32, Mul, Div>( in, n, sums, comps ); }
+	template<std::intmax_t Mul, std::intmax_t Div, typename T>
+	DIMENSIONAL_TARGET("avx512f,avx512dq")
+	inline std::size_t kahan_avx512( const T *in, std::size_t n, T *sums, T *comps )
+	{ return kahan_lanes<64, Mul, Div>( in, n, sums, comps ); }
+
+	#pragma GCC pop_options
+#endif
+
+	template<std::intmax_t ScaleA, std::intmax_t ScaleB, typename Op, typename T, typename R>
+	inline std::size_t heterop_with( std::false_type,
+		isa, Op, const T *, const T *, std::size_t, R * )
+	{ return 0; }
+	template<std::intmax_t ScaleA, std::intmax_t ScaleB, typename Op, typename T, typename R>
+	inline std::size_t heterop_with( std::true_type,
+		isa with, Op op, const T *a, const T *b, std::size_t n, R *out )
+	{
+		switch ( with )
+		{
+		#if DIMENSIONAL_SIMD_X86
+			case isa::avx512: return heterop_avx512<ScaleA,ScaleB>( op, a, b, n, out );
+			case isa::avx2:   return heterop_avx2  <ScaleA,ScaleB>( op, a, b, n, out );
+			case isa::sse2:   return heterop_sse2  <ScaleA,ScaleB>( op, a, b, n, out );
+		#endif
+			default: break;
+		}
+		return 0;
+	}
+
+	// leading elements done by the kernel for the given instruction set
+	// operands of different types are left to the scalar loop
+	template<std::intmax_t ScaleA, std::intmax_t ScaleB,
+		typename Op, typename TA, typename TB, typename R>
+	inline std::size_t heterop_with( isa, Op, const TA *, const TB *, std::size_t, R * )
+	{ return 0; }
+	template<std::intmax_t ScaleA, std::intmax_t ScaleB, typename Op, typename T, typename R>
+	inline std::size_t heterop_with( isa with, Op op, const T *a, const T *b, std::size_t n, R *out )
+	{
+		using vectorized = std::integral_constant< bool,
+			has_lanes<T>::value && lanes_op<Op>::value != lanes_op_code::none >;
+		return heterop_with<ScaleA,ScaleB>( vectorized{}, with, op, a, b, n, out );
+	}
+
+
+	// the most lanes of any kernel, for buffers of per-lane results
+	constexpr std::size_t max_lanes = 64 / sizeof(float);
+
+	// leading elements summed by the kernel for the given instruction set,
+	// into lanes (up to max_lanes) pairs of sums and comps; floating point only
+	template<std::intmax_t Mul, std::intmax_t Div, typename T>
+	inline std::size_t kahan_with( isa with, const T *in, std::size_t n,
+		T *sums, T *comps, std::size_t &lanes )
+	{
+		static_assert( std::is_floating_point<T>::value, "" );
+		lanes = 0;
+		switch ( with )
+		{
+		#if DIMENSIONAL_SIMD_X86
+			case isa::avx512: lanes = 64/sizeof(T); return kahan_avx512<Mul,Div>( in, n, sums, comps );
+			case isa::avx2:   lanes = 32/sizeof(T); return kahan_avx2  <Mul,Div>( in, n, sums, comps );
+			case isa::sse2:   lanes = 16/sizeof(T); return kahan_sse2  <Mul,Div>( in, n, sums, comps );
+		#endif
+			default: break;
+		}
+		return 0;
+	}
+
+
+	// leading elements done by the kernel for the given instruction set
+	template<std::intmax_t Num, std::intmax_t Den, typename T>
+	inline std::size_t rescale_with( isa with, const T *in, std::size_t n, T *out )
+	{
+		switch ( with )
+		{
+			case isa::avx512: return rescale_avx512<Num,Den>( in, n, out );
+			case isa::avx2:   return rescale_avx2  <Num,Den>( in, n, out );
+			case isa::sse2:   return rescale_sse2  <Num,Den>( in, n, out );
+			case isa::scalar: break;
+		}
+		return 0;
+	}
+}}}
+
+#endif
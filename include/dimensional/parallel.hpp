@@ -0,0 +1,342 @@
+// parallel algorithms on ranges of quantities: transform, reduce,
+// transform_reduce and inclusive_scan, split across a pool of threads
+
+#ifndef DIMENSIONAL_PARALLEL_H
+#define DIMENSIONAL_PARALLEL_H
+
+#include "dimensional.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dimensional
+{
+namespace par
+{
+	// a fixed set of worker threads, running one loop of chunks at a time
+	// the thread asking for the loop takes part in it
+	class thread_pool
+	{
+		std::vector<std::thread> workers;
+
+		std::mutex serial;  // one loop at a time
+		std::mutex m;
+		std::condition_variable wake, done;
+		const std::function<void(std::size_t)> *job = nullptr;
+		std::size_t chunks = 0;
+		std::atomic<std::size_t> next{ 0 };
+		std::size_t pending = 0;  // workers yet to leave the loop
+		std::size_t generation = 0;
+		bool stop = false;
+		std::exception_ptr error;
+
+		// loops started from within a loop run inline
+		static bool &inside()
+		{
+			static thread_local bool in = false;
+			return in;
+		}
+
+		void work( const std::function<void(std::size_t)> &f, std::size_t n )
+		{
+			for ( std::size_t i; (i = next++) < n; )
+				try
+				{
+					f( i );
+				}
+				catch ( ... )
+				{
+					std::lock_guard<std::mutex> lock{ m };
+					if ( !error )
+						error = std::current_exception();
+				}
+		}
+
+		void run()
+		{
+			inside() = true;
+			std::size_t seen = 0;
+			std::unique_lock<std::mutex> lock{ m };
+			for (;;)
+			{
+				wake.wait( lock, [&]{ return stop || generation != seen; } );
+				if ( stop )
+					return;
+				seen = generation;
+				const auto f = job;
+				const auto n = chunks;
+				lock.unlock();
+				work( *f, n );
+				lock.lock();
+				if ( --pending == 0 )
+					done.notify_one();
+			}
+		}
+
+	public:
+		// threads: the number of threads taking part in a loop, caller included
+		explicit thread_pool( unsigned threads = std::max( std::thread::hardware_concurrency(), 1u ) )
+		{
+			workers.reserve( threads - 1 );
+			for ( unsigned i = 1; i < threads; ++i )
+				workers.emplace_back( [this]{ run(); } );
+		}
+		thread_pool( const thread_pool & ) = delete;
+		thread_pool &operator=( const thread_pool & ) = delete;
+		~thread_pool()
+		{
+			{
+				std::lock_guard<std::mutex> lock{ m };
+				stop = true;
+			}
+			wake.notify_all();
+			for ( auto &w : workers )
+				w.join();
+		}
+
+		std::size_t size() const { return workers.size() + 1; }
+
+		// f( i ) for every i in [0, n), in no particular order or thread
+		// returns when all are done; rethrows the first exception, if any
+		template<typename F>
+		void for_each_chunk( std::size_t n, F f )
+		{
+			if ( n <= 1 || workers.empty() || inside() )
+			{
+				for ( std::size_t i = 0; i < n; ++i )
+					f( i );
+				return;
+			}
+			std::lock_guard<std::mutex> one_at_a_time{ serial };
+			const std::function<void(std::size_t)> fun{ std::ref(f) };
+			{
+				std::lock_guard<std::mutex> lock{ m };
+				job = &fun;
+				chunks = n;
+				next = 0;
+				pending = workers.size();
+				error = nullptr;
+				++generation;
+			}
+			wake.notify_all();
+			inside() = true;
+			work( fun, n );
+			inside() = false;
+			std::unique_lock<std::mutex> lock{ m };
+			done.wait( lock, [&]{ return pending == 0; } );
+			if ( error )
+				std::rethrow_exception( error );
+		}
+
+		// the pool the algorithms use unless given one
+		static thread_pool &shared()
+		{
+			static thread_pool pool;
+			return pool;
+		}
+	};
+
+
+	namespace impl
+	{
+		// fewer elements than that aren't worth a thread
+		constexpr std::size_t grain = 4096;
+
+		// [begin(k), begin(k+1)) for k in [0, count): near-equal chunks of n
+		struct chunking
+		{
+			std::size_t n, count;
+
+			chunking( const thread_pool &pool, std::size_t n )
+				: n(n), count( std::max<std::size_t>( 1, std::min( pool.size(), n / grain ) ) ) {}
+
+			std::size_t begin( std::size_t k ) const { return n / count * k + std::min( k, n % count ); }
+		};
+
+		template<typename Range>
+		using iterator_t = decltype( std::begin( std::declval<Range &>() ) );
+		// quantities, not the proxies of quantity_iterator
+		template<typename Range>
+		using value_t = typename std::iterator_traits< iterator_t<Range> >::value_type;
+
+		template<typename Range>
+		inline std::size_t size( Range &r )
+		{ return static_cast<std::size_t>( std::end(r) - std::begin(r) ); }
+
+		// the type of init op elem, folded over the elements: with quantities,
+		// in the common unit of all the operands (see dimensional::impl::heterop)
+		template<typename Op, typename Init, typename Elem>
+		using fold_t = std::decay_t< decltype( std::declval<Op>()(
+			std::declval<Init>(), std::declval<Elem>() ) ) >;
+
+		// op-fold of transform( i ) over [from, to); from < to
+		template<typename R, typename Op, typename Transform>
+		inline R fold( Op &op, Transform &transform, std::size_t from, std::size_t to )
+		{
+			R acc( transform( from ) );
+			for ( std::size_t i = from+1; i < to; ++i )
+				acc = op( acc, transform( i ) );
+			return acc;
+		}
+
+		// init op transform( 0 ) op ... op transform( n-1 ), chunks in parallel
+		template<typename R, typename Init, typename Op, typename Transform>
+		inline R reduce_n( thread_pool &pool, std::size_t n, Init init, Op op, Transform transform )
+		{
+			R res( init );
+			if ( n == 0 )
+				return res;
+			const chunking c{ pool, n };
+			std::vector<R> partial( c.count, R( init ) );
+			pool.for_each_chunk( c.count, [&]( std::size_t k ) {
+				partial[k] = fold<R>( op, transform, c.begin(k), c.begin(k+1) );
+			} );
+			for ( const auto &p : partial )
+				res = op( res, p );
+			return res;
+		}
+	}
+
+
+	// out[i] = f( in[i] ), for all i
+	template<typename In, typename Out, typename F>
+	inline void transform( thread_pool &pool, const In &in, Out &&out, F f )
+	{
+		const std::size_t n = impl::size( in );
+		assert( impl::size( out ) >= n );
+		const auto first = std::begin( in );
+		const auto res = std::begin( out );
+		const impl::chunking c{ pool, n };
+		pool.for_each_chunk( c.count, [&]( std::size_t k ) {
+			for ( std::size_t i = c.begin(k); i < c.begin(k+1); ++i )
+				res[i] = f( impl::value_t<const In>( first[i] ) );
+		} );
+	}
+	template<typename In, typename Out, typename F>
+	inline void transform( const In &in, Out &&out, F f )
+	{ par::transform( thread_pool::shared(), in, std::forward<Out>(out), f ); }
+
+
+	// init op r[0] op ... op r[n-1], in unspecified order
+	// with quantities and +, the result is in the common unit of init and
+	// the elements, as for init + r[0]; so are the per-thread partial sums
+	template<typename Range, typename Init, typename Op>
+	inline auto reduce( thread_pool &pool, const Range &r, Init init, Op op )
+	{
+		using elem = impl::value_t<const Range>;
+		using R = impl::fold_t<Op, Init, elem>;
+		const auto first = std::begin( r );
+		return impl::reduce_n<R>( pool, impl::size( r ), init, op,
+			[first]( std::size_t i ) { return elem( first[i] ); } );
+	}
+	template<typename Range, typename Init>
+	inline auto reduce( thread_pool &pool, const Range &r, Init init )
+	{ return par::reduce( pool, r, init, std::plus<>{} ); }
+	// zero of the elements' unit for init
+	template<typename Range>
+	inline auto reduce( thread_pool &pool, const Range &r )
+	{ return par::reduce( pool, r, impl::value_t<const Range>{} ); }
+
+	template<typename Range, typename Init, typename Op>
+	inline auto reduce( const Range &r, Init init, Op op )
+	{ return par::reduce( thread_pool::shared(), r, init, op ); }
+	template<typename Range, typename Init>
+	inline auto reduce( const Range &r, Init init )
+	{ return par::reduce( thread_pool::shared(), r, init ); }
+	template<typename Range>
+	inline auto reduce( const Range &r )
+	{ return par::reduce( thread_pool::shared(), r ); }
+
+
+	// init op transform( r[0] ) op ... op transform( r[n-1] )
+	template<typename Range, typename Init, typename Op, typename Transform>
+	inline auto transform_reduce( thread_pool &pool, const Range &r, Init init,
+		Op op, Transform transform )
+	{
+		using elem = impl::value_t<const Range>;
+		using R = impl::fold_t< Op, Init, decltype( transform( std::declval<elem>() ) ) >;
+		const auto first = std::begin( r );
+		return impl::reduce_n<R>( pool, impl::size( r ), init, op,
+			[first, &transform]( std::size_t i ) { return transform( elem( first[i] ) ); } );
+	}
+	// init + a[0]*b[0] + ... + a[n-1]*b[n-1]; b at least as long as a
+	template<typename RangeA, typename RangeB, typename Init>
+	inline auto transform_reduce( thread_pool &pool, const RangeA &a, const RangeB &b, Init init )
+	{
+		using elem_a = impl::value_t<const RangeA>;
+		using elem_b = impl::value_t<const RangeB>;
+		using product = decltype( std::declval<elem_a>() * std::declval<elem_b>() );
+		using R = impl::fold_t< std::plus<>, Init, product >;
+		assert( impl::size( b ) >= impl::size( a ) );
+		const auto first_a = std::begin( a );
+		const auto first_b = std::begin( b );
+		return impl::reduce_n<R>( pool, impl::size( a ), init, std::plus<>{},
+			[first_a, first_b]( std::size_t i ) { return elem_a( first_a[i] ) * elem_b( first_b[i] ); } );
+	}
+
+	template<typename Range, typename Init, typename Op, typename Transform>
+	inline auto transform_reduce( const Range &r, Init init, Op op, Transform transform )
+	{ return par::transform_reduce( thread_pool::shared(), r, init, op, transform ); }
+	template<typename RangeA, typename RangeB, typename Init>
+	inline auto transform_reduce( const RangeA &a, const RangeB &b, Init init )
+	{ return par::transform_reduce( thread_pool::shared(), a, b, init ); }
+
+
+	// out[i] = in[0] op ... op in[i], for all i
+	// computed as op-folds of the elements, so the running values are in
+	// the unit of in[0] op in[0] (for +, just that of the elements),
+	// and converted to that of out on assignment
+	template<typename In, typename Out, typename Op>
+	inline void inclusive_scan( thread_pool &pool, const In &in, Out &&out, Op op )
+	{
+		using elem = impl::value_t<const In>;
+		using R = impl::fold_t<Op, elem, elem>;
+		const std::size_t n = impl::size( in );
+		assert( impl::size( out ) >= n );
+		if ( n == 0 )
+			return;
+		const auto first = std::begin( in );
+		const auto res = std::begin( out );
+		const impl::chunking c{ pool, n };
+		auto value = [first]( std::size_t i ) { return elem( first[i] ); };
+
+		// the totals of the chunks, then each chunk carrying the ones before
+		std::vector<R> carry( c.count, R( value(0) ) );
+		pool.for_each_chunk( c.count - 1, [&]( std::size_t k ) {
+			carry[k+1] = impl::fold<R>( op, value, c.begin(k), c.begin(k+1) );
+		} );
+		for ( std::size_t k = 2; k < c.count; ++k )
+			carry[k] = op( carry[k-1], carry[k] );
+		pool.for_each_chunk( c.count, [&]( std::size_t k ) {
+			std::size_t i = c.begin(k);
+			R acc = k == 0 ? R( value(i) ) : op( carry[k], value(i) );
+			res[i] = acc;
+			for ( ++i; i < c.begin(k+1); ++i )
+				res[i] = acc = op( acc, value(i) );
+		} );
+	}
+	template<typename In, typename Out>
+	inline void inclusive_scan( thread_pool &pool, const In &in, Out &&out )
+	{ par::inclusive_scan( pool, in, std::forward<Out>(out), std::plus<>{} ); }
+
+	template<typename In, typename Out, typename Op,
+		typename = std::enable_if_t< !std::is_same<In, thread_pool>::value >>
+	inline void inclusive_scan( const In &in, Out &&out, Op op )
+	{ par::inclusive_scan( thread_pool::shared(), in, std::forward<Out>(out), op ); }
+	template<typename In, typename Out>
+	inline void inclusive_scan( const In &in, Out &&out )
+	{ par::inclusive_scan( thread_pool::shared(), in, std::forward<Out>(out) ); }
+}
+}
+
+#endif
@@ -0,0 +1,406 @@
+// run-time units from strings, e.g. "kg*m/s^2" or "1852/1000 k m",
+// with the symbols of si.hpp and a parse cache
+
+#ifndef DIMENSIONAL_PARSE_H
+#define DIMENSIONAL_PARSE_H
+
+#include "dynamic.hpp"
+#include "si.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace dimensional
+{
+	// thrown for strings that aren't unit expressions
+	struct unit_parse_error : std::invalid_argument
+	{
+		using std::invalid_argument::invalid_argument;
+	};
+
+
+	// the names a unit expression may use: units, and prefixes to them
+	class unit_symbols
+	{
+		std::unordered_map<std::string, dyn_unit> units;
+		std::unordered_map<std::string, rational> prefixes;
+		std::size_t longest_prefix = 0;
+
+	public:
+		void add_unit( std::string name, dyn_unit u )
+		{ units[std::move(name)] = u; }
+		void add_prefix( std::string name, rational scale )
+		{
+			longest_prefix = std::max( longest_prefix, name.size() );
+			prefixes[std::move(name)] = scale;
+		}
+
+		//   A name is a unit, a prefix on its own (a plain factor then), or
+		// a prefix glued to a unit, the longest prefix first: "m" is metre,
+		// "k" is 1000, "km" is kilometre. False if it's none of these.
+		bool find( const std::string &name, dyn_unit &res ) const
+		{
+			const auto u = units.find( name );
+			if ( u != units.end() )
+				return res = u->second, true;
+			const auto p = prefixes.find( name );
+			if ( p != prefixes.end() )
+				return res = dyn_unit{ dyn_dimension{}, p->second }, true;
+			for ( std::size_t n = std::min( longest_prefix, name.size() - 1 ); n > 0; --n )
+			{
+				const auto pre = prefixes.find( name.substr( 0, n ) );
+				const auto rest = units.find( name.substr( n ) );
+				if ( pre != prefixes.end() && rest != units.end() )
+					return res = dyn_unit{ rest->second.dimension,
+						pre->second * rest->second.scale }, true;
+			}
+			return false;
+		}
+	};
+
+	//   The units and prefixes of si.hpp, by symbol and by name, and the
+	// minute, hour and day; "h" and "d" are these alone, prefixes when glued.
+	inline unit_symbols si_symbols()
+	{
+		using namespace si;
+		unit_symbols sym;
+		const std::pair<const char *, dyn_unit> units[] =
+		{
+			{ "m", si::unit::m }, { "metre", si::unit::m }, { "meter", si::unit::m },
+			{ "g", g }, { "gram", g },
+			{ "s", s }, { "second", s },
+			{ "A", A }, { "ampere", A },
+			{ "K", K }, { "kelvin", K },
+			{ "mol", mol }, { "mole", mol },
+			{ "cd", cd }, { "candela", cd },
+			{ "rad", rad }, { "radian", rad },
+			{ "sr", sr }, { "steradian", sr },
+			{ "Hz", Hz }, { "hertz", Hz },
+			{ "N", N }, { "newton", N },
+			{ "Pa", Pa }, { "pascal", Pa },
+			{ "J", J }, { "joule", J },
+			{ "W", W }, { "watt", W },
+			{ "C", C }, { "coulomb", C },
+			{ "V", V }, { "volt", V },
+			{ "F", si::unit::F }, { "farad", si::unit::F },
+			{ "O", O }, { "\u03A9", O }, { "ohm", O },
+			{ "S", S }, { "siemens", S },
+			{ "Wb", Wb }, { "weber", Wb },
+			{ "T", si::unit::T }, { "tesla", si::unit::T },
+			{ "H", H }, { "henry", H },
+			{ "degC", degC }, { "degree_celsius", degC },
+			{ "lm", lm }, { "lumen", lm },
+			{ "lx", lx }, { "lux", lx },
+			{ "Bq", Bq }, { "becquerel", Bq },
+			{ "Gy", Gy }, { "gray", Gy },
+			{ "Sv", Sv }, { "sievert", Sv },
+			{ "kat", kat }, { "katal", kat },
+			{ "min", 60_*s }, { "minute", 60_*s },
+			{ "h", 3600_*s }, { "hour", 3600_*s },
+			{ "d", 86400_*s }, { "day", 86400_*s },
+		};
+		for ( const auto &u : units )
+			sym.add_unit( u.first, u.second );
+		const std::pair<const char *, rational> prefixes[] =
+		{
+			{ "da", da }, { "deca", da },
+			{ "h", h }, { "hecto", h },
+			{ "k", k }, { "kilo", k },
+			{ "M", M }, { "mega", M },
+			{ "G", G }, { "giga", G },
+			{ "T", si::prefix::T }, { "tera", si::prefix::T },
+			{ "P", P }, { "peta", P },
+			{ "E", E }, { "exa", E },
+			{ "d", d }, { "deci", d },
+			{ "c", c }, { "centi", c },
+			{ "m", si::prefix::m }, { "milli", si::prefix::m },
+			{ "u", u }, { "\u03BC", u }, { "\u00B5", u }, { "micro", u },
+			{ "n", n }, { "nano", n },
+			{ "p", p }, { "pico", p },
+			{ "f", f }, { "femto", f },
+			{ "a", a }, { "atto", a },
+		};
+		for ( const auto &p : prefixes )
+			sym.add_prefix( p.first, p.second );
+		return sym;
+	}
+
+
+	namespace impl
+	{
+		//   Recursive descent over
+		//     expr    = term { ["*" | "/"] term }    (juxtaposition multiplies)
+		//     term    = primary [ "^" power ]
+		//     primary = number | name | "(" expr ")"
+		//     power   = ["-"] integer | "(" ["-"] integer ["/" integer] ")"
+		// with numbers like 1852 or 0.3048, and names of letters, '_' and
+		// any non-ASCII (UTF-8) characters.
+		class unit_expression
+		{
+			const std::string &text;
+			const unit_symbols &symbols;
+			std::size_t pos = 0;
+
+			[[noreturn]] void fail( const char *what ) const
+			{
+				throw unit_parse_error{ std::string{ what } + " at " +
+					std::to_string( pos ) + " in unit \"" + text + "\"" };
+			}
+
+			static bool is_digit( char c ) { return c >= '0' && c <= '9'; }
+			static bool is_name( char c )
+			{
+				return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+					static_cast<unsigned char>( c ) >= 0x80;
+			}
+
+			char peek()
+			{
+				while ( pos < text.size() && (text[pos] == ' ' || text[pos] == '\t') )
+					++pos;
+				return pos < text.size() ? text[pos] : '\0';
+			}
+			bool take( char c )
+			{
+				if ( peek() != c )
+					return false;
+				++pos;
+				return true;
+			}
+
+			intmax_t integer()
+			{
+				if ( !is_digit( peek() ) )
+					fail( "integer expected" );
+				intmax_t n = 0;
+				for ( ; pos < text.size() && is_digit( text[pos] ); ++pos )
+					if ( __builtin_mul_overflow( n, 10, &n ) ||
+					     __builtin_add_overflow( n, text[pos] - '0', &n ) )
+						fail( "number out of range" );
+				return n;
+			}
+			rational number()
+			{
+				rational res{ integer() };
+				if ( pos < text.size() && text[pos] == '.' )
+				{
+					++pos;
+					intmax_t frac = 0, scale = 1;
+					for ( ; pos < text.size() && is_digit( text[pos] ); ++pos )
+						if ( __builtin_mul_overflow( frac, 10, &frac ) ||
+						     __builtin_add_overflow( frac, text[pos] - '0', &frac ) ||
+						     __builtin_mul_overflow( scale, 10, &scale ) ||
+						     __builtin_mul_overflow( res.num, 10, &res.num ) )
+							fail( "number out of range" );
+					if ( __builtin_add_overflow( res.num, frac, &res.num ) )
+						fail( "number out of range" );
+					res = rational{ res.num, scale };
+				}
+				return res;
+			}
+			dyn_unit name()
+			{
+				const std::size_t start = pos;
+				while ( pos < text.size() && is_name( text[pos] ) )
+					++pos;
+				dyn_unit res;
+				if ( !symbols.find( text.substr( start, pos - start ), res ) )
+				{
+					pos = start;
+					fail( "unknown unit" );
+				}
+				return res;
+			}
+			dyn_unit primary()
+			{
+				const char c = peek();
+				if ( is_digit( c ) )
+				{
+					const std::size_t start = pos;
+					const rational n = number();
+					if ( n.num == 0 )
+					{
+						pos = start;
+						fail( "zero scale" );
+					}
+					return { dyn_dimension{}, n };
+				}
+				if ( is_name( c ) )
+					return name();
+				if ( !take( '(' ) )
+					fail( "unit expected" );
+				const dyn_unit res = expr();
+				if ( !take( ')' ) )
+					fail( "')' expected" );
+				return res;
+			}
+			rational power()
+			{
+				const bool group = take( '(' );
+				const bool negative = take( '-' );
+				intmax_t num = integer(), den = 1;
+				if ( group && take( '/' ) )
+					den = integer();
+				if ( group && !take( ')' ) )
+					fail( "')' expected" );
+				if ( den == 0 )
+					fail( "zero denominator" );
+				return { negative ? -num : num, den };
+			}
+			dyn_unit term()
+			{
+				const dyn_unit base = primary();
+				if ( !take( '^' ) )
+					return base;
+				try
+				{
+					return base.pow( power() );
+				}
+				catch ( const std::range_error & )
+				{
+					fail( "power not representable" );
+				}
+			}
+			dyn_unit expr()
+			{
+				dyn_unit res = term();
+				for ( ;; )
+				{
+					const char c = peek();
+					if ( take( '*' ) )
+						res = res * term();
+					else if ( take( '/' ) )
+						res = res / term();
+					else if ( is_digit( c ) || is_name( c ) || c == '(' )
+						res = res * term();
+					else
+						return res;
+				}
+			}
+
+		public:
+			unit_expression( const std::string &text, const unit_symbols &symbols )
+				: text(text), symbols(symbols) {}
+
+			dyn_unit parse()
+			{
+				dyn_unit res;
+				try
+				{
+					res = expr();
+				}
+				catch ( const std::overflow_error & )
+				{
+					fail( "scale or exponent out of range" );
+				}
+				catch ( const std::domain_error & )
+				{
+					fail( "division by zero" );
+				}
+				if ( peek() != '\0' )
+					fail( "unexpected character" );
+				return res;
+			}
+		};
+	}
+
+	// text as a unit of the given symbols, parsed anew
+	inline dyn_unit parse_unit( const std::string &text, const unit_symbols &symbols )
+	{ return impl::unit_expression{ text, symbols }.parse(); }
+
+
+	//   Parses each distinct string once: the units are kept in a hash table
+	// split into shards, each with chains of nodes that are only ever
+	// prepended to and live as long as the parser. Lookups of strings seen
+	// before take no lock; a new string is parsed outside of any lock, and
+	// its shard's mutex is only held to publish the result. Strings that
+	// fail to parse aren't kept, and neither are any once capacity strings
+	// are: those are parsed anew each time.
+	class unit_parser
+	{
+		struct node
+		{
+			std::string text;
+			dyn_unit unit;
+			const node *next;
+		};
+
+		static constexpr std::size_t shards = 16, buckets = 64;  // per shard
+		struct shard
+		{
+			std::mutex m;
+			std::atomic<const node *> heads[buckets];
+
+			shard()
+			{
+				for ( auto &h : heads )
+					h.store( nullptr, std::memory_order_relaxed );
+			}
+			~shard()
+			{
+				for ( auto &h : heads )
+					for ( const node *n = h.load( std::memory_order_relaxed ); n; )
+						delete std::exchange( n, n->next );
+			}
+		};
+
+		unit_symbols symbols;
+		std::unique_ptr<shard[]> table{ new shard[shards] };
+		const std::size_t capacity;
+		std::atomic<std::size_t> count{ 0 };
+
+	public:
+		explicit unit_parser( unit_symbols symbols, std::size_t capacity = 4096 )
+			: symbols(std::move(symbols)), capacity(capacity) {}
+		unit_parser( const unit_parser & ) = delete;
+		unit_parser &operator=( const unit_parser & ) = delete;
+
+		// the parser with si_symbols() behind parse_unit
+		static unit_parser &si()
+		{
+			static unit_parser parser{ si_symbols() };
+			return parser;
+		}
+
+		// the number of strings kept
+		std::size_t size() const noexcept
+		{ return count.load( std::memory_order_relaxed ); }
+
+		dyn_unit parse( const std::string &text )
+		{
+			const std::size_t h = std::hash<std::string>{}( text );
+			shard &sh = table[h % shards];
+			std::atomic<const node *> &head = sh.heads[h / shards % buckets];
+			for ( const node *n = head.load( std::memory_order_acquire ); n; n = n->next )
+				if ( n->text == text )
+					return n->unit;
+			const dyn_unit u = parse_unit( text, symbols );
+			std::lock_guard<std::mutex> lock{ sh.m };
+			const node *first = head.load( std::memory_order_relaxed );
+			for ( const node *n = first; n; n = n->next )
+				if ( n->text == text )
+					return n->unit;
+			if ( count.fetch_add( 1, std::memory_order_relaxed ) >= capacity )
+			{
+				count.fetch_sub( 1, std::memory_order_relaxed );
+				return u;
+			}
+			const node *n = new node{ text, u, first };
+			head.store( n, std::memory_order_release );
+			return n->unit;
+		}
+	};
+
+	// text as a unit of si_symbols(), parsed once per distinct string
+	inline dyn_unit parse_unit( const std::string &text )
+	{ return unit_parser::si().parse( text ); }
+}
+
+#endif
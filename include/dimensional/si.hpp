@@ -1,7 +1,114 @@
 
+#ifndef DIMENSIONAL_SI_H
+#define DIMENSIONAL_SI_H
+
 #include "dimensional.hpp"
 #include <chrono>
 
+
+#ifdef DIMENSIONAL_NAMED_DIMENSIONS
+#include "si_fwd.hpp"
+
+// Short names for the dimensions of si units: quantities, operators, symbols
+// and diagnostics then spell e.g. si::named::force instead of the whole
+// dimension_product. Opt-in, and must be enabled in all TUs or in none.
+namespace si
+{
+	inline namespace dimen
+	{
+		struct _length_tag;
+		struct _mass_tag;
+		struct _time_tag;
+		struct _energy_tag;
+		struct _charge_tag;
+		struct _temperature_tag;
+		struct _substance_tag;
+		struct _luminous_intensity_tag;
+	}
+
+	namespace impl
+	{
+		template<typename Tag, intmax_t Power = 1>
+		using factor = dimensional::dimension_factor< Tag, dimensional::constant<Power> >;
+	}
+
+	namespace named
+	{
+		using dimensional::canonical_dimension;
+		using impl::factor;
+
+		// base
+		struct length      : canonical_dimension< factor<_length_tag> > {};
+		struct mass        : canonical_dimension< factor<_mass_tag> > {};
+		struct time        : canonical_dimension< factor<_time_tag> > {};
+		struct energy      : canonical_dimension< factor<_energy_tag> > {};
+		struct charge      : canonical_dimension< factor<_charge_tag> > {};
+		struct temperature : canonical_dimension< factor<_temperature_tag> > {};
+		struct substance   : canonical_dimension< factor<_substance_tag> > {};
+		struct luminous_intensity
+			: canonical_dimension< factor<_luminous_intensity_tag> > {};
+
+		// derived
+		struct current   : canonical_dimension< factor<_charge_tag>, factor<_time_tag,-1> > {};
+		struct potential : canonical_dimension< factor<_energy_tag>, factor<_charge_tag,-1> > {};
+		struct power     : canonical_dimension< factor<_energy_tag>, factor<_time_tag,-1> > {};
+		struct volume    : canonical_dimension< factor<_length_tag,3> > {};
+		struct flow      : canonical_dimension< factor<_length_tag,3>, factor<_time_tag,-1> > {};
+		struct area      : canonical_dimension< factor<_length_tag,2> > {};
+		struct velocity  : canonical_dimension< factor<_length_tag>, factor<_time_tag,-1> > {};
+		struct acceleration
+			: canonical_dimension< factor<_length_tag>, factor<_time_tag,-2> > {};
+		struct frequency : canonical_dimension< factor<_time_tag,-1> > {};
+
+		// of the derived units
+		struct force    // N
+			: canonical_dimension< factor<_mass_tag>, factor<_length_tag>, factor<_time_tag,-2> > {};
+		struct pressure // Pa
+			: canonical_dimension< factor<_mass_tag>, factor<_length_tag,-1>, factor<_time_tag,-2> > {};
+		struct work     // J
+			: canonical_dimension< factor<_mass_tag>, factor<_length_tag,2>, factor<_time_tag,-2> > {};
+		struct mechanical_power // W
+			: canonical_dimension< factor<_mass_tag>, factor<_length_tag,2>, factor<_time_tag,-3> > {};
+		struct voltage  // V
+			: canonical_dimension< factor<_mass_tag>, factor<_length_tag,2>, factor<_time_tag,-2>,
+				factor<_charge_tag,-1> > {};
+		struct capacitance // F
+			: canonical_dimension< factor<_mass_tag,-1>, factor<_length_tag,-2>, factor<_time_tag,2>,
+				factor<_charge_tag,2> > {};
+		struct resistance  // Ω
+			: canonical_dimension< factor<_mass_tag>, factor<_length_tag,2>, factor<_time_tag,-1>,
+				factor<_charge_tag,-2> > {};
+		struct conductance // S
+			: canonical_dimension< factor<_mass_tag,-1>, factor<_length_tag,-2>, factor<_time_tag>,
+				factor<_charge_tag,2> > {};
+		struct magnetic_flux // Wb
+			: canonical_dimension< factor<_mass_tag>, factor<_length_tag,2>, factor<_time_tag,-1>,
+				factor<_charge_tag,-1> > {};
+		struct magnetic_flux_density // T
+			: canonical_dimension< factor<_mass_tag>, factor<_time_tag,-1>, factor<_charge_tag,-1> > {};
+		struct inductance  // H
+			: canonical_dimension< factor<_mass_tag>, factor<_length_tag,2>, factor<_charge_tag,-2> > {};
+		struct illuminance // lx
+			: canonical_dimension< factor<_luminous_intensity_tag>, factor<_length_tag,-2> > {};
+		struct absorbed_dose // Gy
+			: canonical_dimension< factor<_length_tag,2>, factor<_time_tag,-2> > {};
+		struct catalytic_activity // kat
+			: canonical_dimension< factor<_substance_tag>, factor<_time_tag,-1> > {};
+	}
+}
+
+namespace dimensional
+{
+#define DIMENSIONAL_SI_NAME(Name) \
+	template<> struct dimension_name< si::named::Name::canonical_type > \
+	{ using type = si::named::Name; };
+
+	DIMENSIONAL_SI_NAMED_DIMENSIONS(DIMENSIONAL_SI_NAME)
+
+#undef DIMENSIONAL_SI_NAME
+}
+#endif
+
 // Système International d’unités
 namespace si
 {
@@ -164,3 +271,26 @@ namespace mjk
 		}
 	};
 }
+
+namespace dimensional
+{
+	template<typename T, typename Unit>
+	class quantity_span;
+
+	// array of std::chrono::durations -> time quantity_span of their counts,
+	// in place (the span comes with bulk.hpp)
+	template<typename Rep, typename Period>
+	inline auto as_quantities( std::chrono::duration<Rep, Period> *data, std::size_t size )
+	{
+		using unit_type = decltype(constant<Period::num, Period::den>{} * si::second);
+		return quantity_span<Rep, unit_type>{ impl::counts_in<Rep>( data ), size };
+	}
+	template<typename Rep, typename Period>
+	inline auto as_quantities( const std::chrono::duration<Rep, Period> *data, std::size_t size )
+	{
+		using unit_type = decltype(constant<Period::num, Period::den>{} * si::second);
+		return quantity_span<const Rep, unit_type>{ impl::counts_in<const Rep>( data ), size };
+	}
+}
+
+#endif
@@ -0,0 +1,67 @@
+// forward declarations of the quantities of the coherent si units
+// for interfaces that only pass quantities around; include si.hpp to
+// operate on them
+
+#ifndef DIMENSIONAL_SI_FWD_H
+#define DIMENSIONAL_SI_FWD_H
+
+// (the names being those of DIMENSIONAL_NAMED_DIMENSIONS, which has to be
+// defined in every TU, not just those including this)
+#ifndef DIMENSIONAL_NAMED_DIMENSIONS
+	#error "si_fwd.hpp needs DIMENSIONAL_NAMED_DIMENSIONS defined in every TU"
+#endif
+
+#include <cstdint>
+
+namespace meta
+{
+	template<std::intmax_t Num, std::intmax_t Den>
+	struct rational_constant;
+}
+
+namespace dimensional
+{
+	template<typename Dimension, typename Scale>
+	struct unit;
+	template<typename T, typename Unit>
+	class quantity;
+}
+
+// X(name) for every dimension in si::named
+#define DIMENSIONAL_SI_NAMED_DIMENSIONS(X) \
+	X(length) X(mass) X(time) X(energy) X(charge) X(temperature) \
+	X(substance) X(luminous_intensity) \
+	X(current) X(potential) X(power) X(volume) X(flow) \
+	X(area) X(velocity) X(acceleration) X(frequency) \
+	X(force) X(pressure) X(work) X(mechanical_power) X(voltage) \
+	X(capacitance) X(resistance) X(conductance) X(magnetic_flux) \
+	X(magnetic_flux_density) X(inductance) X(illuminance) \
+	X(absorbed_dose) X(catalytic_activity)
+
+namespace si
+{
+	// defined in si.hpp
+	namespace named
+	{
+	#define DIMENSIONAL_SI_DECLARE(Name) struct Name;
+		DIMENSIONAL_SI_NAMED_DIMENSIONS(DIMENSIONAL_SI_DECLARE)
+	#undef DIMENSIONAL_SI_DECLARE
+	}
+
+	// quantity in the coherent si unit of Dimension, e.g. metres for length
+	template<typename Dimension, typename T = double>
+	using coherent_quantity = dimensional::quantity< T,
+		dimensional::unit< Dimension, meta::rational_constant<1,1> > >;
+
+	// e.g. si::quantities::force<float>
+	namespace quantities
+	{
+	#define DIMENSIONAL_SI_DECLARE(Name) \
+		template<typename T = double> \
+		using Name = coherent_quantity< named::Name, T >;
+		DIMENSIONAL_SI_NAMED_DIMENSIONS(DIMENSIONAL_SI_DECLARE)
+	#undef DIMENSIONAL_SI_DECLARE
+	}
+}
+
+#endif
@@ -0,0 +1,92 @@
+#include "../include/dimensional/accumulator.hpp"
+#include "../include/dimensional/parallel.hpp"
+#include "../include/dimensional/si.hpp"
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+namespace
+{
+	// n kg in 1/P kg, for each P
+	template<intmax_t... P, typename Acc>
+	void add_parts( Acc &acc, int n )
+	{
+		const int each[] = { (acc += n*(dimensional::constant<1, P>{}*si::kg), 0)... };
+		(void)each;
+	}
+}
+
+#include "test.hpp"
+test
+{
+	using namespace si;
+	using dimensional::accumulator;
+	using dimensional::quantity_vector;
+	using meta::is_same;
+
+	using kg_t  = decltype(0*kg);
+	using m_u   = std::decay_t<decltype(unit::m)>;
+	using m_t   = decltype(0.0*unit::m);
+	using mm_u  = decltype(milli*unit::m);
+
+	{
+		// the README's infinite loop, made finite
+		setup( unsigned steps = 0 );
+		setup( for ( accumulator<kg_t> m; m.value() < 1*kg; m += 1*g ) ++steps );
+		expect( steps )eq( 1000u );
+		setup( accumulator<kg_t> m );
+		setup( for ( unsigned i = 0; i < 1500; ++i ) m -= 1*g );
+		expect( m.value().count() )eq( -1 );
+		setup( m += 500*g );
+		expect( m.value().count() )eq( -1 );
+		setup( m -= 1*(milli*g) );
+		expect( m.value().count() )eq( -1 );
+		setup( m += 1001*(milli*g) );
+		expect( m.value().count() )eq( 0 );
+		cexpect( is_same< decltype(m.value()), kg_t >::value );
+	}
+	{
+		// more coprime scales than a common denominator has room for
+		setup( accumulator<kg_t> m );
+		setup( add_parts<2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47,
+			53, 59, 61, 67, 71, 73, 79, 83, 89, 97>( m, 3 ) );
+		expect( m.value().count() )eq( 5 );  // 3 * 1.803...
+		setup( add_parts<2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47,
+			53, 59, 61, 67, 71, 73, 79, 83, 89, 97>( m, -3 ) );
+		expect( m.value().count() )eq( 0 );
+	}
+	{
+		setup( accumulator<decltype(0.0f*kg)> m );
+		setup( float naive = 0 );
+		setup( for ( unsigned i = 0; i < 1'000'000; ++i ) m += 0.001f*kg, naive += 0.001f );
+		expect( m.value().count() )eq( static_cast<float>( 1e6 * double{0.001f} ) );
+		expect( naive == m.value().count() )eq( false );
+		setup( accumulator<decltype(0.0*kg)> grams );
+		setup( for ( unsigned i = 0; i < 1000; ++i ) grams += 1.0*g );
+		expect( grams.value().count() )eq( 1.0 );
+	}
+	{
+		setup( quantity_vector<double, m_u> v( 100'003, 0.1*unit::m ) );
+		setup( accumulator<m_t> sum );
+		setup( sum.add( v.cspan() ) );
+		expect( sum.value().count() )eq( 100'003 * 0.1 );
+		expect( std::accumulate( v.cbegin(), v.cend(), 0.0*unit::m ).count() == 100'003 * 0.1 )eq( false );
+		setup( quantity_vector<double, mm_u> mm( 100'003, 100.0*(milli*unit::m) ) );
+		setup( accumulator<m_t> from_mm );
+		setup( from_mm.add( mm.cspan() ) );
+		expect( std::abs( from_mm.value().count() - 10'000.3 ) < 1e-11 )eq( true );
+		setup( quantity_vector<float, m_u> f( 1037, 1.0f*unit::m ) );
+		setup( from_mm.add( f.cspan() ) );
+		expect( std::abs( from_mm.value().count() - 11'037.3 ) < 1e-11 )eq( true );
+	}
+	{
+		// as the reduction type
+		setup( quantity_vector<double, m_u> v( 100'003, 0.1*unit::m ) );
+		setup( dimensional::par::thread_pool pool{ 4 } );
+		setup( const auto sum = dimensional::par::reduce( pool, v, accumulator<m_t>{} ) );
+		cexpect( is_same< decltype(sum), const accumulator<m_t> >::value );
+		expect( sum.value().count() )eq( 100'003 * 0.1 );
+		setup( const m_t plain = std::accumulate( v.cbegin(), v.cend(), accumulator<m_t>{} ) );
+		expect( plain.count() )eq( 100'003 * 0.1 );
+	}
+}
@@ -0,0 +1,78 @@
+#include "../include/dimensional/any.hpp"
+#include "../include/dimensional/parse.hpp"
+#include "../include/dimensional/si.hpp"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// whether the count is kept in the any_quantity itself
+	template<typename T>
+	bool in_place( const dimensional::any_quantity &q )
+	{
+		const auto p = reinterpret_cast<std::uintptr_t>( &q.count<T>() );
+		const auto begin = reinterpret_cast<std::uintptr_t>( &q );
+		return p >= begin && p + sizeof(T) <= begin + sizeof q;
+	}
+}
+
+#include "test.hpp"
+test
+{
+	using namespace si;
+	using dimensional::any_quantity;
+	using dimensional::dyn_unit;
+	using dimensional::rational;
+	using dimensional::rounding::nearest;
+
+	{
+		setup( std::vector<any_quantity> readings );
+		setup( readings.reserve( 4 ) );
+		setup( readings.emplace_back( 1500*unit::m ) );
+		setup( readings.emplace_back( 2.5*(kilo*unit::m) ) );
+		setup( readings.emplace_back( 20.f*degC ) );
+		setup( readings.emplace_back( 'x'*A ) );
+		setup( const std::vector<any_quantity> copies = readings );
+		setup( readings = copies );
+		setup( std::swap( readings[0], readings[1] ) );
+		expect( in_place<int>( readings[1] ) )eq( true );
+		expect( in_place<double>( readings[0] ) )eq( true );
+		expect( in_place<char>( readings[3] ) )eq( true );
+		expect( readings[1].holds<int>() )eq( true );
+		expect( readings[1].count<int>() )eq( 1500 );
+		expect( readings[0].unit() == dyn_unit{ kilo*unit::m } )eq( true );
+		expect( readings[0].to<double>( unit::m ).count() )eq( 2500. );
+		expect( readings[0].to<double>( kilo*unit::m ).count() )eq( 2.5 );
+		expect( readings[1].to<int>( kilo*unit::m ).count() )eq( 1 );
+		expect( readings[1].to<int>( kilo*unit::m, nearest{} ).count() )eq( 2 );
+		expect( readings[1].to<int>( milli*unit::m ).count() )eq( 1500000 );
+		expect( readings[2].to<float>( degC ).count() )eq( 20.f );
+		expect( readings[3].count<char>() )eq( 'x' );
+		cexpect( dimensional::impl::any_in_place<long double>::value );
+		cexpect( noexcept( std::declval<any_quantity &>() = std::declval<any_quantity>() ) );
+	}
+	{
+		setup( const any_quantity q = 3*s );
+		expect( throws<dimensional::bad_any_quantity_cast>( [&]{ q.to<long>( s ); } ) )eq( true );
+		expect( throws<dimensional::dimension_error>( [&]{ q.to<int>( unit::m ); } ) )eq( true );
+		expect( q.to<int>( s ).count() )eq( 3 );
+		expect( any_quantity{}.has_value() )eq( false );
+		expect( q.has_value() )eq( true );
+		expect( q.dimension() == si::time )eq( true );
+	}
+	{
+		// of run-time units, and of counts too big to keep in place
+		setup( const any_quantity speed{ 36., dimensional::parse_unit( "km/h" ) } );
+		expect( speed.to<double>( unit::m/s ).count() )eq( 10. );
+		setup( any_quantity words{ std::string( 100, 'w' ), dyn_unit{} } );
+		setup( any_quantity moved{ std::move(words) } );
+		expect( in_place<std::string>( moved ) )eq( false );
+		expect( words.has_value() )eq( false );
+		expect( moved.count<std::string>().size() )eq( 100u );
+		setup( any_quantity copy = moved );
+		expect( copy.count<std::string>() == moved.count<std::string>() )eq( true );
+		expect( &copy.count<std::string>() == &moved.count<std::string>() )eq( false );
+	}
+}
@@ -0,0 +1,153 @@
+#include "../include/dimensional/bulk.hpp"
+#include "../include/dimensional/si.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#include "test.hpp"
+test
+{
+	using namespace si;
+	using dimensional::quantity_vector;
+	using dimensional::quantity_span;
+	using meta::is_same;
+
+	using mm_t = decltype(1.0*(milli*unit::m));
+	using  m_t = decltype(1.0*unit::m);
+	using mV   = decltype(milli*V);
+	using ns   = decltype(nano*s);
+	using m_u  = std::decay_t<decltype(unit::m)>;
+	using s_u  = std::decay_t<decltype(s)>;
+	using mm_u = decltype(milli*unit::m);
+
+	cexpect( sizeof(quantity_span<double, mV>) == sizeof(double *) + sizeof(std::size_t) );
+
+	{
+		setup( quantity_vector<double, mV> v( 3, 1.5*(milli*V) ) );
+		expect( v.size() )eq( 3u );
+		expect( v[2].get().count() )eq( 1.5 );
+		cexpect( is_same< decltype(v.data()), double * >::value );
+		cexpect( is_same< decltype(v.front().get()), decltype(1.0*(milli*V)) >::value );
+	}
+	{
+		setup( quantity_vector<double, mV> v{ 1.0*V, 2.0*(milli*V) } );
+		expect( v.raw().size() )eq( 2u );
+		expect( v.data()[0] )eq( 1000.0 );
+		expect( v.data()[1] )eq( 2.0 );
+	}
+	{
+		setup( quantity_vector<double, mV> v( 2 ) );
+		setup( v[0] = 3.0*V );
+		setup( v[1] = v[0] );
+		setup( v[1] += 1.0*(milli*V) );
+		expect( v.data()[0] )eq( 3000.0 );
+		expect( v.data()[1] )eq( 3001.0 );
+	}
+	{
+		setup( quantity_vector<std::int64_t, ns> v{} );
+		setup( for ( std::int64_t i = 0; i < 4; ++i ) v.push_back( i*s ) );
+		expect( v.back().get().count() )eq( 3'000'000'000 );
+		setup( quantity_vector<std::int64_t, s_u> res{ v } );
+		expect( res.data()[3] )eq( 3 );
+		setup( quantity_vector<double, decltype(micro*s)> us{ v } );
+		expect( us.data()[1] )eq( 1e6 );
+	}
+	{
+		// the same values as element-by-element conversion
+		setup( quantity_vector<float, decltype(milli*unit::m)> v{} );
+		setup( for ( float x = 0; x < 37; x += 0.37f ) v.push_back( x*(milli*unit::m) ) );
+		setup( quantity_vector<float, decltype(kilo*unit::m)> res{ v } );
+		setup( bool same = true );
+		setup( for ( std::size_t i = 0; i < v.size(); ++i )
+			same = same && res.data()[i] == decltype(res[i].get()){ v[i].get() }.count() );
+		expect( same )eq( true );
+	}
+	{
+		setup( quantity_vector<double, m_u> v{ 1.0*unit::m, 2.0*unit::m, 3.0*unit::m } );
+		setup( quantity_span<const double, m_u> s = v );
+		expect( s.size() )eq( 3u );
+		setup( const auto sum = std::accumulate( s.begin(), s.end(), 0.0*unit::m ) );
+		expect( sum.count() )eq( 6.0 );
+		cexpect( is_same< decltype(sum), const m_t >::value );
+		setup( const auto mm = quantity_vector<double, decltype(milli*unit::m)>{ s.subspan(1, 2) } );
+		expect( mm.data()[0] )eq( 2000.0 );
+		cexpect( is_same< decltype(mm[0]), mm_t >::value );
+	}
+	{
+		setup( quantity_vector<double, m_u> v{ 3.0*unit::m, 1.0*unit::m, 2.0*unit::m } );
+		setup( auto s = v.view() );
+		setup( std::fill( s.begin(), s.begin()+1, 4.0*unit::m ) );
+		setup( std::reverse( s.begin(), s.end() ) );
+		expect( v.data()[0] )eq( 2.0 );
+		expect( v.data()[2] )eq( 4.0 );
+		setup( quantity_vector<double, mm_u> mm( v.size() ) );
+		setup( dimensional::convert( v.cspan(), mm.view() ) );
+		expect( mm.data()[2] )eq( 4000.0 );
+		setup( dimensional::convert( mm.view(), mm.view() ) );
+		expect( mm.data()[2] )eq( 4000.0 );
+		setup( double raw[3] );
+		setup( std::memcpy( raw, v.data(), sizeof raw ) );
+		expect( raw[1] )eq( 1.0 );
+	}
+	{
+		// merging streams recorded in different units
+		setup( quantity_vector<double, decltype(kilo*unit::m)> km{ 1.0*(kilo*unit::m), 2.0*(kilo*unit::m), 0.5*(kilo*unit::m) } );
+		setup( quantity_vector<double, m_u> m{ 1.0*unit::m, 2000.0*unit::m, 700.0*unit::m } );
+		setup( const auto sum = dimensional::add( km.cspan(), m.cspan() ) );
+		cexpect( is_same< decltype(sum[0]), decltype(km[0].get() + m[0].get()) >::value );
+		expect( sum.data()[0] )eq( 1001.0 );
+		expect( sum.data()[1] )eq( 4000.0 );
+		setup( const auto diff = dimensional::subtract( km.cspan(), m.cspan() ) );
+		expect( diff.data()[2] )eq( -200.0 );
+		setup( bool lt[3], eq[3] );
+		setup( dimensional::less( km.cspan(), m.cspan(), lt ) );
+		setup( dimensional::equal( km.cspan(), m.cspan(), eq ) );
+		expect( lt[0] )eq( false );
+		expect( lt[2] )eq( true );
+		expect( eq[1] )eq( true );
+		expect( eq[2] )eq( false );
+	}
+	{
+		setup( quantity_vector<std::int64_t, decltype(milli*s)> ms{ 1*s, 2*(milli*s) } );
+		setup( quantity_vector<std::int64_t, decltype(micro*s)> us{ 5*(micro*s), 7*(micro*s) } );
+		setup( quantity_vector<std::int64_t, decltype(micro*s)> res( 2 ) );
+		setup( dimensional::add( ms.view(), us.view(), res.view() ) );
+		expect( res.data()[0] )eq( 1'000'005 );
+		expect( res.data()[1] )eq( 2'007 );
+	}
+	{
+		// buffers viewed in place
+		setup( std::int32_t frame[3] = { 10, -20, 30 } );
+		setup( const auto mv = dimensional::as_quantities( frame, 3, milli*V ) );
+		cexpect( is_same< decltype(mv), const quantity_span<std::int32_t, mV> >::value );
+		expect( mv.data() == frame )eq( true );
+		expect( mv[1].get() == -20*(milli*V) )eq( true );
+		setup( mv[2] = 1*V );
+		expect( frame[2] )eq( 1'000 );
+		setup( std::vector<decltype(1.0*unit::m)> lengths{ 1.0*unit::m, 2.5*unit::m } );
+		setup( const auto view = dimensional::as_quantities( lengths.data(), lengths.size() ) );
+		cexpect( is_same< decltype(view), const quantity_span<double, m_u> >::value );
+		expect( view.data() == &lengths[0].count() )eq( true );
+		setup( const quantity_vector<double, mm_u> mm{ view } );
+		expect( mm.data()[1] )eq( 2'500.0 );
+		setup( const std::vector<decltype(1.0*unit::m)> &clengths = lengths );
+		cexpect( is_same< decltype(dimensional::as_quantities( clengths.data(), 2 )),
+			quantity_span<const double, m_u> >::value );
+	}
+	{
+		using namespace std::chrono;
+		setup( std::vector<nanoseconds> stamps{ nanoseconds{ 1'500 }, microseconds{ 2 } } );
+		setup( const auto t = dimensional::as_quantities( stamps.data(), stamps.size() ) );
+		cexpect( is_same< decltype(t), const quantity_span<nanoseconds::rep, ns> >::value );
+		expect( t[0].get() == 1'500*(nano*s) )eq( true );
+		expect( t[1].get() < 3*(micro*s) )eq( true );
+		setup( t[0] += 1*(micro*s) );
+		expect( stamps[0].count() )eq( 2'500 );
+		setup( const auto &cstamps = stamps );
+		setup( quantity_vector<std::int64_t, decltype(micro*s)> us{
+			dimensional::as_quantities( cstamps.data(), cstamps.size() ) } );
+		expect( us.data()[1] )eq( 2 );
+	}
+}
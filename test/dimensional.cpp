@@ -1,10 +1,12 @@
 
 #include "../include/dimensional/dimensional.hpp"
+#include <cstdint>
 
 
 // type name printing
 #include <typeinfo>
 #include <cxxabi.h>
+#include <cstdlib>
 #include <memory>
 #include <new>
 template<typename Stream, typename T>
@@ -65,6 +67,28 @@ test
 			expect( seq::front_f(res.factors).get().tag )eq( type<tag>{} );
 			expect( seq::front_f(res.factors).get().power )eq( 2_ );
 		}
+
+		{
+			setup( constexpr auto d = dimension<tag>{} );
+			setup( constexpr auto res = d/d );
+			expect( res )eq( dimensionless );
+		}
+	}
+
+	{
+		constexpr auto M = dimension<struct mass>{};
+		constexpr auto L = dimension<struct length>{};
+		constexpr auto T = dimension<struct time>{};
+
+		{
+			setup( constexpr auto a = L/(T^2_) );
+			setup( constexpr auto res = M*a );
+			expect( seq::size_f(res.factors) )eq( 3_ );
+			expect( type<decltype(+res)>{} )eq( type<decltype(a*M)>{} );
+			expect( type<decltype(+res)>{} )eq( type<decltype(L*M/T/T)>{} );
+			expect( type<decltype(res/M)>{} )eq( type<decltype(+a)>{} );
+			expect( res/L/M*(T^2_) )eq( dimensionless );
+		}
 	}
 
 	{
@@ -167,5 +191,57 @@ test
 			expect( 1 *kg )eq( 1000.*g );
 			expect( 1.*kg )eq( 1000.*g );
 		}
+
+		{
+			// power-of-two scales: shifted, yet truncated like any division
+			constexpr auto B   = unit_of( dimension<struct information>{} );
+			constexpr auto KiB = 1'024_* B;
+			constexpr auto kB  = 1'000_* B;
+			setup();
+			expect( (3*KiB).to( B ).count() )eq( 3'072 );
+			expect( (1'025*B).to( KiB ).count() )eq( 1 );
+			expect( (-1'025*B).to( KiB ).count() )eq( -1 );
+			expect( (-1'023*B).to( KiB ).count() )eq( 0 );
+			expect( (5*kB).to( KiB ).count() )eq( 4 );
+			expect( (-5*kB).to( KiB ).count() )eq( -4 );
+			expect( (1'536.0*B).to( KiB ).count() )eq( 1.5 );
+			expect( (0.3*kB).to( KiB ).count() )eq( 0.3*1'000/1'024 );
+			expect( 3*KiB + 1*B )eq( 3'073*B );
+		}
+
+		{
+			constexpr auto B   = unit_of( dimension<struct information>{} );
+			constexpr auto KiB = 1'024_* B;
+			constexpr auto kB  = 1'000_* B;
+			constexpr auto ns  = unit_of( dimension<struct time>{} );
+			constexpr auto ms  = 1'000'000_* ns;
+			constexpr rounding::nearest nearest{};
+			constexpr rounding::floor   floor{};
+			constexpr rounding::ceil    ceil{};
+			setup();
+			expect( (1'499*g).to( kg, nearest ).count() )eq( 1 );
+			expect( (1'500*g).to( kg, nearest ).count() )eq( 2 );
+			expect( (-1'500*g).to( kg, nearest ).count() )eq( -2 );
+			expect( (-1'499*g).to( kg, nearest ).count() )eq( -1 );
+			expect( (-1*g).to( kg, floor ).count() )eq( -1 );
+			expect( (1'999*g).to( kg, floor ).count() )eq( 1 );
+			expect( (-1'000*g).to( kg, floor ).count() )eq( -1 );
+			expect( (1*g).to( kg, ceil ).count() )eq( 1 );
+			expect( (-1'999*g).to( kg, ceil ).count() )eq( -1 );
+			expect( (1'000*g).to( kg, ceil ).count() )eq( 1 );
+			expect( (1'500u*g).to( kg, nearest ).count() )eq( 2u );
+			expect( (1u*g).to( kg, ceil ).count() )eq( 1u );
+			expect( (-5*kB).to( KiB, nearest ).count() )eq( -5 );
+			expect( (-5*kB).to( KiB, floor ).count() )eq( -5 );
+			expect( (-5*kB).to( KiB, ceil ).count() )eq( -4 );
+			expect( (3*kg).to( g, floor ).count() )eq( 3'000 );
+			expect( (INT64_MIN*ns).to( ms, floor ).count() )eq( INT64_MIN / 1'000'000 - 1 );
+			expect( (INT64_MIN*ns).to( ms, nearest ).count() )eq( INT64_MIN / 1'000'000 - 1 );
+			expect( (INT64_MIN*ns).to( ms ).count() )eq( INT64_MIN / 1'000'000 );
+			expect( (INT64_MAX*ns).to( ms, ceil ).count() )eq( INT64_MAX / 1'000'000 + 1 );
+			expect( (UINT64_MAX*ns).to( ms, nearest ).count() )eq( UINT64_MAX / 1'000'000 + 1 );
+			expect( (UINT64_MAX*ns).to( ms, floor ).count() )eq( UINT64_MAX / 1'000'000 );
+			cexpect( (2'500*g).to( kg, nearest ).count() == 3 );
+		}
 	}
 }
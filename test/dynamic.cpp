@@ -0,0 +1,73 @@
+#include "../include/dimensional/dynamic.hpp"
+#include "../include/dimensional/si.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+
+#include "test.hpp"
+test
+{
+	using namespace si;
+	using dimensional::dyn_dimension;
+	using dimensional::rational;
+	using meta::is_same;
+
+	{
+		setup( constexpr rational r{ 1852, -1000 } );
+		expect( r.num )eq( -463 );
+		expect( r.den )eq( 250 );
+		expect( r * rational{ 250, 463 } == rational{ -1 } )eq( true );
+		expect( r / r == rational{ dimensional::constant<1>{} } )eq( true );
+		expect( throws<std::overflow_error>( [&]{ rational{ INTMAX_MAX } * rational{ 2 }; } ) )eq( true );
+		expect( throws<std::domain_error>( [&]{ r / rational{}; } ) )eq( true );
+	}
+	{
+		setup( const dyn_dimension len = length, t = si::time );
+		setup( const dyn_dimension force = mass*length/(si::time^2_) );
+		expect( dyn_dimension{}.dimensionless() )eq( true );
+		expect( dyn_dimension{ dimensional::dimensionless } == dyn_dimension{} )eq( true );
+		expect( len == t )eq( false );
+		expect( len/t == length/si::time )eq( true );
+		expect( dyn_dimension{ mass }*len/(t*t) == force )eq( true );
+		expect( (force/force).dimensionless() )eq( true );
+		expect( force.is( (kg*unit::m/(s*s)).dimension ) )eq( true );
+		expect( force.is( energy ) )eq( false );
+		expect( force.exponent( si::time ) == rational{ -2 } )eq( true );
+		expect( force.exponent( charge ) == rational{} )eq( true );
+		expect( std::hash<dyn_dimension>{}( force ) )eq( std::hash<dyn_dimension>{}( (kg*N/kg).dimension ) );
+	}
+	{
+		// and back
+		setup( const dyn_dimension area = length^2_ );
+		setup( const auto static_area = area.as( length*length ) );
+		cexpect( is_same< decltype(static_area), const decltype(+(length^2_)) >::value );
+		expect( throws<dimensional::dimension_error>( [&]{ area.as( length ); } ) )eq( true );
+		expect( area.pow( rational{ 1, 2 } ) == length )eq( true );
+		expect( area.pow( rational{ 1, 3 } ).exponent( length ) == rational{ 2, 3 } )eq( true );
+		expect( throws<std::range_error>( [&]{ area.pow( rational{ 1, 5 } ); } ) )eq( true );
+		expect( throws<std::range_error>( [&]{ area.pow( rational{ INTMAX_MAX / 2 } ); } ) )eq( true );
+		expect( area.pow( rational{ 1, 4 } ).exponent( length ) == rational{ 1, 2 } )eq( true );
+		setup( const dyn_dimension l21 = length^21_ );
+		expect( throws<std::overflow_error>( [&]{ l21*l21; } ) )eq( true );
+		expect( throws<std::overflow_error>( [&]{ dyn_dimension{}/l21/l21; } ) )eq( true );
+		expect( (l21/l21).dimensionless() )eq( true );
+	}
+	{
+		// tags known by name only
+		setup( const dyn_dimension usd = dyn_dimension::base( "USD" ) );
+		setup( const dyn_dimension price = usd/mass );
+		expect( price.exponent( "USD" ) == rational{ 1 } )eq( true );
+		expect( price == dyn_dimension::base( "EUR" )/mass )eq( false );
+		expect( price*dyn_dimension{ mass } == dyn_dimension::base( "USD" ) )eq( true );
+		setup( std::unordered_set<dyn_dimension> dims{ usd, price, usd/mass, length } );
+		expect( dims.size() )eq( 3u );
+	}
+	{
+		// lookups of tags never seen take no lanes
+		for ( char c = 'a'; c <= 'z'; ++c )
+			expect( dyn_dimension{}.exponent( std::string( 1, c ) ) == rational{} )eq( true );
+		expect( dyn_dimension{ length }.exponent( dimension<struct unseen_tag>{} ) == rational{} )eq( true );
+		expect( dyn_dimension::base( "AUD" ).exponent( "AUD" ) == rational{ 1 } )eq( true );
+	}
+}
@@ -0,0 +1,112 @@
+#include "../include/dimensional/dynamic_scale.hpp"
+#include "../include/dimensional/si.hpp"
+#include <stdexcept>
+#include <type_traits>
+
+namespace
+{
+	using namespace dimensional;
+
+	scale_source usd_per_eur{ 1.25 };
+	scale_source usd_per_gbp{ 1.5 };
+	scale_source gain{ 2 };
+	scale_source rate{ 2.3 };
+
+	constexpr auto money = dimension<struct money_tag>{};
+	constexpr auto usd = unit_of( money );
+	constexpr auto eur = dynamic_scale<usd_per_eur>{} * usd;
+	constexpr auto gbp = dynamic_scale<usd_per_gbp>{} * usd;
+	constexpr auto eurocent = constant<1, 100>{} * eur;
+
+	template<typename T, typename Unit>
+	using quantity_of = quantity< T, std::remove_const_t<Unit> >;
+
+	// a data type whose arithmetic may throw
+	struct amount
+	{
+		double v;
+		amount( double v ) : v(v) {}
+	};
+	inline amount operator*( const amount &a, double b ) { return a.v * b; }
+}
+
+#include "test.hpp"
+test
+{
+	using si::kilo;
+	using si::milli;
+	using si::unit::V;
+	using meta::is_same;
+
+	{
+		setup( const auto price = 8.*eur );
+		cexpect( is_same< decltype(price), const quantity_of<double, decltype(eur)> >::value );
+		cexpect( sizeof price == sizeof(double) );
+		setup( const quantity_of<double, decltype(usd)> in_usd = price );
+		expect( in_usd.count() )eq( 10. );
+		expect( price.to( kilo*usd ).count() )eq( .01 );
+		expect( price.to( gbp ).count() )eq( 10./1.5 );
+		setup( const decltype(price) back = 10.*usd );
+		expect( back.count() )eq( 8. );
+		setup( const quantity_of<int, decltype(eurocent)> cents = price );
+		expect( cents.count() )eq( 800 );
+		setup( usd_per_eur.set( 2.5 ) );
+		expect( quantity_of<double, decltype(usd)>{ price }.count() )eq( 20. );
+		expect( decltype(price){ 10.*usd }.count() )eq( 4. );
+		expect( price.to( gbp ).count() )eq( 20./1.5 );
+		setup( usd_per_eur.set( 1.25 ) );
+	}
+	{
+		// integer counts rounded as asked
+		using dimensional::rounding::nearest;
+		using dimensional::rounding::floor;
+		using dimensional::rounding::ceil;
+		using cents = quantity_of<int, decltype(eurocent)>;
+		expect( cents( .29*eur, nearest{} ).count() )eq( 29 );
+		expect( cents( .2949*usd, nearest{} ).count() )eq( 24 );
+		expect( cents( .295*eur, floor{} ).count() )eq( 29 );
+		expect( cents( .295*eur, ceil{} ).count() )eq( 30 );
+		expect( cents( -.295*eur, floor{} ).count() )eq( -30 );
+		expect( quantity_of<int, decltype(eur)>{ 3*eur }.to( eurocent ).count() )eq( 300 );
+		// products a rounding error short of an integer are that integer
+		setup( constexpr auto rated = dynamic_scale<rate>{} * usd );
+		expect( quantity_of<long, decltype(rated)>{ 100 }.to( usd ).count() )eq( 230 );
+		expect( cents( .57*eur ).count() )eq( 57 );
+		expect( quantity_of<long, decltype(usd)>{ quantity_of<long, decltype(rated)>{ 100 } }.count() )eq( 230 );
+		cexpect( noexcept( cents( .29*eur, nearest{} ) ) );
+		cexpect( noexcept( (.29*eur).to( usd ) ) );
+		cexpect( !noexcept( quantity_of<amount, decltype(eur)>{ quantity_of<amount, decltype(usd)>{ 1. } } ) );
+		cexpect( !noexcept( quantity_of<amount, decltype(eur)>{ 1. }.to( usd ) ) );
+	}
+	{
+		// per instance
+		setup( auto raw = make_scale( gain ) * (milli*V) );
+		expect( raw.quantity_of( 100., V ).count() )eq( .2 );
+		expect( raw.quantity_of( 100., milli*V ).count() )eq( 200. );
+		expect( raw.count_of( .5*V ) )eq( 250. );
+		setup( gain.set( 4 ) );
+		expect( raw.scale.stale() )eq( true );
+		expect( raw.quantity_of( 100., V ).count() )eq( .4 );
+		setup( raw.scale.refresh() );
+		expect( raw.scale.stale() )eq( false );
+		expect( raw.count_of( 1*V ) )eq( 250 );
+		expect( raw.count_of( 1001*(milli*V), dimensional::rounding::nearest{} ) )eq( 250 );
+		expect( raw.count_of( 1003*(milli*V), dimensional::rounding::ceil{} ) )eq( 251 );
+		expect( raw.quantity_of( 3, milli*V, dimensional::rounding::nearest{} ).count() )eq( 12 );
+		cexpect( noexcept( raw.count_of( 1*V ) ) );
+		cexpect( !noexcept( raw.count_of( quantity_of<amount, decltype(V)>{ 1. } ) ) );
+	}
+	{
+		bool thrown = false;
+		try
+		{
+			gain.set( 0 );
+		}
+		catch ( const std::domain_error & )
+		{
+			thrown = true;
+		}
+		expect( thrown )eq( true );
+		expect( gain.factor() )eq( 4. );
+	}
+}
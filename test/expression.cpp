@@ -0,0 +1,80 @@
+#include "../include/dimensional/expression.hpp"
+#include "../include/dimensional/si.hpp"
+#include <cmath>
+#include <cstdint>
+
+#include "test.hpp"
+test
+{
+	using namespace si;
+	using dimensional::quantity_vector;
+	using dimensional::quantity_expression;
+	using meta::is_same;
+
+	using m_u   = std::decay_t<decltype(unit::m)>;
+	using mps   = decltype(unit::m/s);
+	using mps2  = decltype(unit::m/(s^2_));
+	using kmph  = decltype((kilo*unit::m)/(60_*60_*s));
+	using ms    = decltype(milli*s);
+	using us    = decltype(micro*s);
+	using mV    = decltype(milli*V);
+	using mA    = decltype(milli*A);
+	using W_u   = std::decay_t<decltype(W)>;
+
+	{
+		// kinematics: v = u + a*t
+		setup( quantity_vector<double, mps> u{ 1.0*(unit::m/s), 2.0*(unit::m/s), 3.0*(unit::m/s) } );
+		setup( quantity_vector<double, mps2> a{ 10.0*(unit::m/(s^2_)), 0.0*(unit::m/(s^2_)), -1.0*(unit::m/(s^2_)) } );
+		setup( quantity_vector<double, ms> t{ 500.0*(milli*s), 1.0*s, 2000.0*(milli*s) } );
+		setup( const auto e = u + a*t );
+		cexpect( is_same< decltype(e[0]), decltype(u[0].get() + a[0].get()*t[0].get()) >::value );
+		expect( e.size() )eq( 3u );
+		setup( quantity_vector<double, mps> v( 3 ) );
+		setup( v = u + a*t );
+		expect( v.data()[0] )eq( 6.0 );
+		expect( v.data()[1] )eq( 2.0 );
+		expect( v.data()[2] )eq( 1.0 );
+		setup( const auto w = dimensional::evaluate( u + a*t ) );
+		expect( w[0] == v[0].get() )eq( true );
+		setup( quantity_vector<double, kmph> k{ u + a*t } );
+		expect( k.data()[0] )eq( 21.6 );
+	}
+	{
+		// broadcast quantities and numbers
+		setup( quantity_vector<double, ms> t{ 1.0*s, 2.0*s } );
+		setup( const auto g = 9.8*(unit::m/(s^2_)) );
+		setup( quantity_vector<double, m_u> h{ 0.5 * g * t * t } );
+		expect( h.data()[0] )eq( 4.9 );
+		expect( h.data()[1] )eq( 19.6 );
+		setup( quantity_vector<double, mps> u{ g*t + 1.0*(unit::m/s) } );
+		expect( u.data()[1] )eq( 20.6 );
+		setup( quantity_vector<double, decltype(1_/s)> f{ 1.0 / t } );
+		expect( f.data()[0] )eq( 1.0 );
+		setup( quantity_vector<double, ms> half{ t / 2.0 } );
+		expect( half.data()[1] )eq( 1000.0 );
+	}
+	{
+		// power budget over channels recorded in different units
+		setup( quantity_vector<double, mV> rail{ 3300.0*(milli*V), 5000.0*(milli*V) } );
+		setup( quantity_vector<double, mA> load{ 100.0*(milli*A), 2000.0*(milli*A) } );
+		setup( quantity_vector<double, W_u> extra{ 0.5*W, 1.0*W } );
+		setup( quantity_vector<double, W_u> p{ rail*load + extra } );
+		expect( std::abs( p.data()[0] - 0.83 ) < 1e-15 )eq( true );
+		expect( p.data()[1] )eq( 11.0 );
+		setup( p = p + p );
+		expect( p.data()[1] )eq( 22.0 );
+	}
+	{
+		// integers: the same values as element-wise arithmetic
+		setup( quantity_vector<std::int64_t, ms> a{ 1*s, 2*(milli*s), 1999*(milli*s) } );
+		setup( quantity_vector<std::int64_t, us> b{ 5*(micro*s), 7*(micro*s), 999*(micro*s) } );
+		setup( quantity_vector<std::int64_t, us> sum{ a + b } );
+		expect( sum.data()[0] )eq( 1'000'005 );
+		expect( sum.data()[2] )eq( 1'999'999 );
+		setup( quantity_vector<std::int64_t, ms> coarse{ a + b } );
+		expect( coarse.data()[2] )eq( decltype(coarse[2].get()){ a[2].get() + b[2].get() }.count() );
+		setup( quantity_vector<std::int64_t, decltype(s/s)> ratio{ (a + b) / b } );
+		expect( ratio.data()[0] )eq( 200'001 );
+		expect( ratio.data()[2] )eq( ((a[2].get() + b[2].get()) / b[2].get()).count() );
+	}
+}
@@ -0,0 +1,74 @@
+#include "../include/dimensional/fixed.hpp"
+#include "../include/dimensional/bulk.hpp"
+#include "../include/dimensional/si.hpp"
+#include <cstdint>
+
+#include "test.hpp"
+test
+{
+	using namespace si;
+	using dimensional::fixed;
+	using dimensional::raw_quantity;
+	using dimensional::fixed_quantity;
+	using dimensional::quantity_vector;
+	using meta::is_same;
+
+	using q16 = fixed<std::int32_t, 16>;
+	using q32 = fixed<std::int64_t, 32>;
+
+	{
+		setup( constexpr q16 x = q16( 3 ) / q16( 2 ) );
+		expect( x.raw() )eq( 3 << 15 );
+		expect( int( x ) )eq( 1 );
+		expect( int( -x ) )eq( -1 );
+		expect( double( x ) )eq( 1.5 );
+		expect( x * q16( 4 ) == 6 )eq( true );
+		expect( x + 1 == q16( 2.5 ) )eq( true );
+		expect( 1 - x == q16( -0.5 ) )eq( true );
+		expect( x * 3 == q16( 4.5 ) )eq( true );
+		expect( x / 3 == q16( 0.5 ) )eq( true );
+		expect( x < 2 && x > 1 )eq( true );
+		expect( (q16( -1 ) / q16( 3 )).raw() )eq( -(65536 / 3) );
+		expect( (q32( 1 ) / q32( 3 ) * q32( 3 )).raw() )eq( (std::int64_t{1} << 32) - 1 );
+		// long long being a type of its own
+		expect( (fixed<long long, 32>( 1000 ) * fixed<long long, 32>( 1000 )).raw() )eq( 1'000'000LL << 32 );
+		expect( (fixed<long long, 32>( 1000 ) / fixed<long long, 32>( 8 )).raw() )eq( 125LL << 32 );
+	}
+	{
+		setup( constexpr auto len = q16( 3 ) / q16( 2 ) * unit::m );
+		setup( constexpr auto raw = raw_quantity( len ) );
+		cexpect( is_same< decltype(raw.count()), const std::int32_t & >::value );
+		expect( raw.count() )eq( 3 << 15 );
+		expect( raw.unit == dimensional::constant<1, 65536>{} * unit::m )eq( true );
+		// in mm: times 125, then shifted down by 13; no floating point
+		expect( raw.to( milli*unit::m ).count() )eq( 1'500 );
+		expect( fixed_quantity<16>( raw ) == len )eq( true );
+		setup( constexpr auto mm = len.to( milli*unit::m ) );
+		cexpect( is_same< decltype(mm.count()), const q16 & >::value );
+		expect( int( mm.count() ) )eq( 1'500 );
+		expect( (q16( 1'500 )*(milli*unit::m)).to( unit::m ).count() == q16( 1.5 ) )eq( true );
+		expect( (q16( 1'499 )*(milli*unit::m)).to( unit::m ).count() < q16( 1.5 ) )eq( true );
+	}
+	{
+		// heterop with integer quantities
+		setup( constexpr auto len = q16( 3 ) / q16( 2 ) * unit::m );
+		setup( const auto sum = len + 250*(milli*unit::m) );
+		cexpect( is_same< decltype(sum.count()), const q16 & >::value );
+		expect( int( sum.count() ) )eq( 1'750 );
+		expect( sum.unit == milli*unit::m )eq( true );
+		expect( len < 1'501*(milli*unit::m) )eq( true );
+		expect( len == 1'500*(milli*unit::m) )eq( true );
+		setup( const auto wide = dimensional::add( dimensional::overflow::widening{}, len, 1*(milli*unit::m) ) );
+		cexpect( is_same< decltype(wide.count()), const fixed<std::int64_t, 16> & >::value );
+		expect( double( wide.count() ) )eq( 1'501.0 );
+	}
+	{
+		setup( quantity_vector<q16, std::decay_t<decltype(unit::m)>> v{ q16( 2 )*unit::m, -q16( 1 )*unit::m } );
+		setup( const quantity_vector<q16, decltype(centi*unit::m)> cm{ v } );
+		expect( int( cm.data()[0] ) )eq( 200 );
+		expect( int( cm.data()[1] ) )eq( -100 );
+		setup( const auto area = v[0].get() * v[1].get() );
+		expect( int( area.count() ) )eq( -2 );
+		expect( area == -2*(unit::m*unit::m) )eq( true );
+	}
+}
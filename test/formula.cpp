@@ -0,0 +1,103 @@
+#include "../include/dimensional/formula.hpp"
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace
+{
+	template<typename Exception>
+	bool fails( const std::string &text,
+		const std::vector<dimensional::formula::variable> &variables = {},
+		const dimensional::dyn_unit &result = {} )
+	{
+		try
+		{
+			dimensional::formula{ text, variables, result };
+		}
+		catch ( const Exception & )
+		{
+			return true;
+		}
+		return false;
+	}
+}
+
+#include "test.hpp"
+test
+{
+	using dimensional::formula;
+	using dimensional::parse_unit;
+	using dimensional::dimension_error;
+	using dimensional::formula_error;
+
+	const std::vector<formula::variable> trip
+	{
+		{ "distance", parse_unit( "km" ) },
+		{ "time", parse_unit( "h" ) },
+		{ "stop", parse_unit( "min" ) },
+	};
+	{
+		// scales folded into one constant: a divide and a multiply
+		setup( const formula speed{ "distance / time", trip, parse_unit( "m/s" ) } );
+		expect( speed.size() )eq( 2u );
+		setup( const formula same{ "distance / time", trip, parse_unit( "km/h" ) } );
+		expect( same.size() )eq( 1u );
+		setup( const double record[] = { 36, 2, 0 } );
+		expect( speed( record ) )eq( 5. );
+		expect( same( record ) )eq( 18. );
+	}
+	{
+		// over batches bigger than a block
+		setup( const std::size_t n = 1000 );
+		setup( std::vector<double> distance( n ), time( n ), stop( n ), out( n ) );
+		for ( std::size_t i = 0; i < n; ++i )
+		{
+			distance[i] = double( i );
+			time[i] = 1;
+			stop[i] = 30;
+		}
+		setup( const double *const columns[] = { distance.data(), time.data(), stop.data() } );
+		setup( const formula pace{ "distance / (time + stop)", trip, parse_unit( "km/h" ) } );
+		setup( pace.evaluate( columns, n, out.data() ) );
+		expect( out[0] )eq( 0. );
+		expect( out[999] )eq( 666. );
+		setup( const formula shifted{ "(-distance + 2 [km]) * 0.5 - [m]", trip, parse_unit( "m" ) } );
+		setup( shifted.evaluate( columns, n, out.data() ) );
+		expect( std::abs( out[10] + 4001 ) < 1e-9 )eq( true );
+		expect( std::abs( out[999] + 498501 ) < 1e-6 )eq( true );
+		setup( const formula area{ "(distance^2)^(1/2) * 1000 + 3 [m^2]^(1/2)", trip, parse_unit( "m" ) } );
+		setup( area.evaluate( columns, n, out.data() ) );
+		expect( std::abs( out[999] - (999e6 + std::sqrt( 3. )) ) < 1e-3 )eq( true );
+	}
+	{
+		setup( const formula constant{ "60 * [s] / [min]", trip } );
+		expect( constant.size() )eq( 1u );
+		expect( constant( nullptr ) )eq( 1. );
+		expect( formula{ "1 / time", trip, parse_unit( "Hz" ) }( std::vector<double>{ 0, .5, 0 }.data() ) )eq( 1/1800. );
+	}
+	{
+		// scales that can't be divided by, or taken roots of
+		setup( const std::vector<formula::variable> xy{ { "x", parse_unit( "m" ) }, { "y", parse_unit( "m" ) } } );
+		setup( const double record[] = { -4, 3 } );
+		expect( formula( "(-x)^(1/2)", xy, parse_unit( "m^(1/2)" ) )( record ) )eq( 2. );
+		expect( std::abs( formula( "(-2*x)^(1/2) * (-x / 8 [m])^(1/2)", xy, parse_unit( "m^(1/2)" ) )( record ) - 2 ) < 1e-12 )eq( true );
+		expect( formula( "0*x + y", xy, parse_unit( "m" ) )( record ) )eq( 3. );
+		expect( formula( "x*0 + 1[m]", xy, parse_unit( "m" ) )( record ) )eq( 1. );
+		expect( formula( "y - x/0", xy, parse_unit( "m" ) )( record ) )eq( INFINITY );
+		setup( const double x[] = { -4, 1 }, y[] = { 3, 5 } );
+		setup( const double *const columns[] = { x, y } );
+		setup( double out[2] );
+		setup( formula( "0*x + y", xy, parse_unit( "m" ) ).evaluate( columns, 2, out ) );
+		expect( out[1] )eq( 5. );
+	}
+	{
+		expect( fails<dimension_error>( "distance + time", trip ) )eq( true );
+		expect( fails<dimension_error>( "distance", trip, parse_unit( "s" ) ) )eq( true );
+		expect( fails<formula_error>( "distance +", trip ) )eq( true );
+		expect( fails<formula_error>( "speed", trip ) )eq( true );
+		expect( fails<formula_error>( "(distance", trip, parse_unit( "m" ) ) )eq( true );
+		expect( fails<formula_error>( "distance^(1/0)", trip ) )eq( true );
+		expect( fails<dimensional::unit_parse_error>( "2 [furlong]" ) )eq( true );
+		expect( fails<formula_error>( "distance / time", trip, parse_unit( "m/s" ) ) )eq( false );
+	}
+}
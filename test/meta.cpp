@@ -1,6 +1,9 @@
 
 #include "../include/dimensional/impl/meta.hpp"
 
+template<typename To, typename From>
+struct nest : meta::identity< meta::sequence<To,From> > {};
+
 int main()
 {
 	using namespace meta;
@@ -10,6 +13,8 @@ int main()
 
 	static_assert( all<true >::value == true,  "" );
 	static_assert( all<false>::value == false, "" );
+	static_assert( any<>::value == false, "" );
+	static_assert( any<false,true>::value == true, "" );
 
 	static_assert(  seq::is_uset< sequence<int> >{}, "" );
 	static_assert( !seq::is_uset< sequence<int,int> >{}, "" );
@@ -20,4 +25,31 @@ int main()
 	static_assert( uset::equal<
 		set<int,long,void,volatile char *const &>,
 		set<long,volatile char *const &,void,int> >{}, "" );
+	static_assert( !uset::equal< set<int,long>, set<int,char> >{}, "" );
+	static_assert( !uset::equal< set<int>, set<int,char> >{}, "" );
+
+	static_assert(  seq::contains< sequence<int,long>, is<long>::pred >{}, "" );
+	static_assert( !seq::contains< sequence<int,long>, is<char>::pred >{}, "" );
+	static_assert( !seq::contains< sequence<>, is<char>::pred >{}, "" );
+
+	using s = sequence<int,long,char,long>;
+	static_assert(  seq::find< s, long >{}, "" );
+	static_assert( !seq::find< s, void >{}, "" );
+	static_assert( is_same< seq::find< s, long >::type, long >{}, "" );
+	static_assert( seq::find< s, long >::tail_size == 2, "" );
+	static_assert( seq::find< s, int  >::tail_size == 3, "" );
+	static_assert( seq::find< sequence<int>, int >{}, "" );
+	static_assert( seq::find< sequence<int>, int >::tail_size == 0, "" );
+	static_assert( seq::find< s, void >::tail_size == 0, "" );
+
+	static_assert( is_same< seq::remove< s, long >, sequence<int,char> >{}, "" );
+	static_assert( is_same< seq::remove< s, void >, s >{}, "" );
+	static_assert( is_same< seq::remove< sequence<>, void >, sequence<> >{}, "" );
+	static_assert( is_same< seq::remove< sequence<int>, int >, sequence<> >{}, "" );
+
+	static_assert( is_same< uset::make< s >, sequence<int,long,char> >{}, "" );
+	static_assert( is_same< uset::make< sequence<> >, sequence<> >{}, "" );
+	static_assert( is_same<
+		uset::make< sequence<int,long,char>, always, nest >,
+		sequence< sequence< sequence<char,long>, int > > >{}, "" );
 }
@@ -0,0 +1,127 @@
+#include "../include/dimensional/dimensional.hpp"
+#include "../include/dimensional/si.hpp"
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+	// stand-in for a big number: its value on the heap, every allocation
+	// counted; the rvalue operators reuse an operand's buffer
+	class big
+	{
+		long *p;
+
+		static long *alloc( long v ) { ++allocations; return new long{ v }; }
+
+	public:
+		static int allocations;
+
+		explicit big( long v = 0 ) : p( alloc(v) ) {}
+		big( const big &o ) : p( alloc(*o.p) ) {}
+		big( big &&o ) noexcept : p( o.p ) { o.p = nullptr; }
+		big &operator=( big o ) noexcept { std::swap( p, o.p ); return *this; }
+		~big() { delete p; }
+
+		long value() const { return *p; }
+		long &value() { return *p; }
+	};
+	int big::allocations = 0;
+
+	template<typename T>
+	using if_big = std::enable_if_t< std::is_same<std::decay_t<T>, big>::value >;
+
+	// result in a's buffer, or b's, or a new one
+	template<typename F>
+	big combine( big &&a, const big &b, F f ) { a.value() = f( a.value(), b.value() ); return std::move(a); }
+	template<typename F>
+	big combine( const big &a, big &&b, F f ) { b.value() = f( a.value(), b.value() ); return std::move(b); }
+	template<typename F>
+	big combine( big &&a, big &&b, F f ) { return combine( std::move(a), b, f ); }
+	template<typename F>
+	big combine( const big &a, const big &b, F f ) { return big{ f( a.value(), b.value() ) }; }
+
+	template<typename A, typename B, typename = if_big<A>, typename = if_big<B>>
+	big operator+( A &&a, B &&b )
+	{ return combine( std::forward<A>(a), std::forward<B>(b), []( long x, long y ){ return x + y; } ); }
+	template<typename A, typename B, typename = if_big<A>, typename = if_big<B>>
+	big operator-( A &&a, B &&b )
+	{ return combine( std::forward<A>(a), std::forward<B>(b), []( long x, long y ){ return x - y; } ); }
+	template<typename A, typename B, typename = if_big<A>, typename = if_big<B>>
+	big operator*( A &&a, B &&b )
+	{ return combine( std::forward<A>(a), std::forward<B>(b), []( long x, long y ){ return x * y; } ); }
+
+	// by the factors of scale conversion, and plain numbers
+	big operator*( big &&a, std::intmax_t n ) { a.value() *= n; return std::move(a); }
+	big operator*( const big &a, std::intmax_t n ) { return big{ a.value() * n }; }
+	big operator*( std::intmax_t n, big &&a ) { return std::move(a) * n; }
+	big operator/( big &&a, std::intmax_t n ) { a.value() /= n; return std::move(a); }
+
+	bool operator< ( const big &a, const big &b ) { return a.value() <  b.value(); }
+	bool operator==( const big &a, const big &b ) { return a.value() == b.value(); }
+
+	// allocations made by f
+	template<typename F>
+	int allocations_in( F f )
+	{
+		const int before = big::allocations;
+		f();
+		return big::allocations - before;
+	}
+}
+
+#include "test.hpp"
+test
+{
+	using namespace si;
+	using dimensional::make_quantity;
+
+	using kg_t = decltype(big{}*kg);
+	using g_t  = decltype(big{}*g);
+
+	setup( kg_t a = big{ 2 }*kg, b = big{ 3 }*kg );
+	setup( g_t c = big{ 500 }*g );
+	{
+		expect( allocations_in( [&]{ make_quantity( big{ 1 }, kg ); } ) )eq( 1 );
+		expect( allocations_in( [&]{ kg_t{ big{ 1 } }; } ) )eq( 1 );
+		expect( allocations_in( [&]{ a + b; } ) )eq( 1 );
+		expect( allocations_in( [&]{ a < b; } ) )eq( 0 );
+		expect( allocations_in( [&]{ a == c; } ) )eq( 1 );  // a in g
+		expect( allocations_in( [&]{ +kg_t{ a }; } ) )eq( 1 );
+	}
+	{
+		setup( kg_t x = a, y = b );
+		expect( allocations_in( [&]{ x = std::move(x) + std::move(y); } ) )eq( 0 );
+		expect( x.count().value() )eq( 5 );
+		expect( allocations_in( [&]{ x = std::move(x) - b; } ) )eq( 0 );
+		expect( allocations_in( [&]{ x = a + std::move(x); } ) )eq( 0 );
+		expect( x.count().value() )eq( 4 );
+		expect( allocations_in( [&]{ x += b; } ) )eq( 0 );
+		expect( allocations_in( [&]{ x -= a; } ) )eq( 0 );
+		expect( x.count().value() )eq( 5 );
+	}
+	{
+		setup( kg_t x = a );
+		setup( g_t grams{} );
+		expect( allocations_in( [&]{ grams = std::move(x).to( g ); } ) )eq( 0 );
+		expect( grams.count().value() )eq( 2'000 );
+		setup( x = a );
+		expect( allocations_in( [&]{ grams = g_t{ std::move(x) }; } ) )eq( 0 );
+		setup( x = a );
+		expect( allocations_in( [&]{ grams = std::move(x) + c; } ) )eq( 0 );
+		expect( grams.count().value() )eq( 2'500 );
+		expect( allocations_in( [&]{ grams = std::move(grams) + g_t{ c }; } ) )eq( 1 );
+	}
+	{
+		setup( kg_t x = a );
+		setup( decltype(big{}*kg*kg) square{} );
+		expect( allocations_in( [&]{ square = std::move(x) * b; } ) )eq( 0 );
+		expect( square.count().value() )eq( 6 );
+		setup( x = a );
+		expect( allocations_in( [&]{ x = 3 * std::move(x); } ) )eq( 0 );
+		expect( allocations_in( [&]{ x = std::move(x) * big{ 2 }; } ) )eq( 1 );
+		expect( x.count().value() )eq( 12 );
+		expect( allocations_in( [&]{ x = std::move(x) / 4; } ) )eq( 0 );
+		expect( x.count().value() )eq( 3 );
+	}
+}
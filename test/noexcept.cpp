@@ -0,0 +1,113 @@
+#include "../include/dimensional/dimensional.hpp"
+#include "../include/dimensional/fixed.hpp"
+#include "../include/dimensional/si.hpp"
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+	// number whose every operation may throw
+	struct risky
+	{
+		int v;
+
+		risky( int v = 0 ) : v( v ) {}
+		risky( const risky &o ) : v( o.v ) {}
+		risky( risky &&o ) : v( o.v ) {}
+		risky &operator=( const risky &o ) { v = o.v; return *this; }
+		risky &operator=( risky &&o ) { v = o.v; return *this; }
+	};
+	risky operator+( const risky &a, const risky &b ) { return a.v + b.v; }
+	risky operator*( const risky &a, const risky &b ) { return a.v * b.v; }
+	risky operator*( const risky &a, std::intmax_t n ) { return a.v * int( n ); }
+	risky operator/( const risky &a, std::intmax_t n ) { return a.v / int( n ); }
+	bool operator<( const risky &a, const risky &b ) { return a.v < b.v; }
+
+	// just as good as an int, but for throwing on copy
+	struct copy_risky
+	{
+		int v = 0;
+
+		copy_risky() = default;
+		copy_risky( const copy_risky &o ) : v( o.v ) {}
+		copy_risky( copy_risky && ) noexcept = default;
+		copy_risky &operator=( const copy_risky & ) = default;
+		copy_risky &operator=( copy_risky && ) noexcept = default;
+	};
+	copy_risky operator*( copy_risky a, copy_risky b ) noexcept { a.v *= b.v; return a; }
+}
+
+#include "test.hpp"
+test
+{
+	using namespace si;
+	using std::declval;
+	namespace overflow = dimensional::overflow;
+
+	using kg_i = decltype(1*kg);
+	using g_i  = decltype(1*g);
+	using kg_d = decltype(1.*kg);
+	using kg_r = decltype(risky{}*kg);
+	using kg_c = decltype(copy_risky{}*kg);
+	using q16  = dimensional::fixed<std::int32_t, 16>;
+	using kg_f = decltype(q16{}*kg);
+
+	{
+		// units, dimensions and constants are empty: nothing to throw
+		cexpect( noexcept( kg*unit::m/(s*s) ) );
+		cexpect( noexcept( kg == g ) );
+		cexpect( noexcept( kilo*g ) );
+		cexpect( noexcept( (kg/unit::m).dimension * (unit::m*unit::m).dimension ) );
+	}
+	{
+		cexpect( noexcept( 1*kg ) );
+		cexpect( noexcept( declval<kg_i>() + declval<g_i>() ) );
+		cexpect( noexcept( declval<kg_i>() - declval<g_i>() ) );
+		cexpect( noexcept( declval<kg_i>() < declval<g_i>() ) );
+		cexpect( noexcept( declval<kg_i>() == declval<g_i>() ) );
+		cexpect( noexcept( declval<kg_i>() * declval<g_i>() ) );
+		cexpect( noexcept( declval<kg_i>() / 2 ) );
+		cexpect( noexcept( declval<kg_i&>() += declval<g_i>() ) );
+		cexpect( noexcept( declval<kg_i>().to( g ) ) );
+		cexpect( noexcept( declval<kg_i>().to( kilo*kg, dimensional::rounding::nearest{} ) ) );
+		cexpect( noexcept( g_i{ declval<kg_i>() } ) );
+		cexpect( noexcept( declval<kg_d>() + declval<kg_d>() ) );
+		cexpect( noexcept( declval<kg_d>().to( g ) ) );
+		cexpect( noexcept( declval<kg_f>() + declval<decltype(1*g)>() ) );
+		cexpect( noexcept( declval<kg_f>().to( g ) ) );
+	}
+	{
+		// but for the overflow policy that throws
+		expect( noexcept( add( overflow::saturating{}, declval<kg_i>(), declval<g_i>() ) ) )eq( true );
+		expect( noexcept( add( overflow::widening{}, declval<kg_i>(), declval<g_i>() ) ) )eq( true );
+		expect( noexcept( add( overflow::checked{}, declval<kg_i>(), declval<g_i>() ) ) )eq( false );
+		// with equal scales, there's nothing to check
+		expect( noexcept( add( overflow::checked{}, declval<kg_i>(), declval<kg_i>() ) ) )eq( true );
+	}
+	{
+		cexpect( !noexcept( risky{}*kg ) );
+		cexpect( !noexcept( declval<kg_r>() + declval<kg_r>() ) );
+		cexpect( !noexcept( declval<kg_r>() < declval<kg_r>() ) );
+		cexpect( !noexcept( declval<kg_r>().to( g ) ) );
+		cexpect( !noexcept( declval<kg_r>() * declval<kg_r>() ) );
+		cexpect( !noexcept( +declval<const kg_r &>() ) );
+		cexpect( noexcept( declval<const kg_r &>().count() ) );
+		// moved, not copied
+		cexpect( noexcept( copy_risky{}*kg ) );
+		cexpect( noexcept( declval<kg_c>() * declval<kg_c>() ) );
+		cexpect( !noexcept( declval<const kg_c &>() * declval<const kg_c &>() ) );
+		cexpect( !noexcept( +declval<const kg_c &>() ) );
+	}
+	{
+		cexpect( std::is_nothrow_move_constructible<kg_i>::value );
+		cexpect( std::is_nothrow_move_assignable<kg_d>::value );
+		cexpect( std::is_trivially_copyable<kg_i>::value );
+		cexpect( std::is_trivially_copyable<kg_d>::value );
+		cexpect( std::is_trivially_copyable<kg_f>::value );
+		cexpect( std::is_nothrow_move_constructible<kg_c>::value );
+		cexpect( !std::is_nothrow_copy_constructible<kg_c>::value );
+		cexpect( !std::is_nothrow_move_constructible<kg_r>::value );
+		cexpect( !std::is_trivially_copyable<kg_r>::value );
+	}
+}
@@ -0,0 +1,75 @@
+#include "../include/dimensional/dimensional.hpp"
+#include "../include/dimensional/bulk.hpp"
+#include "../include/dimensional/si.hpp"
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+// quantities of shorts checked everywhere
+namespace dimensional
+{
+	template<>
+	struct overflow_policy<short>
+	{
+		using type = overflow::checked;
+	};
+}
+
+#include "test.hpp"
+test
+{
+	using namespace si;
+	using dimensional::quantity_vector;
+	using dimensional::add;
+	using dimensional::subtract;
+	using dimensional::less;
+	using dimensional::equal;
+	namespace overflow = dimensional::overflow;
+	using meta::is_same;
+
+	{
+		setup( const auto big = INT_MAX*kg );
+		expect( throws<std::overflow_error>( [&]{ add( overflow::checked{}, big, 0*g ); } ) )eq( true );
+		expect( throws<std::overflow_error>( [&]{ less( overflow::checked{}, 0*g, big ); } ) )eq( true );
+		expect( add( overflow::checked{}, 2*kg, 1*g ).count() )eq( 2001 );
+		// equal scales: nothing to overflow in scaling
+		expect( add( overflow::checked{}, big, 0*kg ).count() )eq( INT_MAX );
+		cexpect( add( overflow::checked{}, 2*kg, 3*kg ).count() == 5 );
+	}
+	{
+		setup( const auto sat = add( overflow::saturating{}, INT_MAX*kg, 0*g ) );
+		expect( sat.count() )eq( INT_MAX );
+		expect( subtract( overflow::saturating{}, INT_MIN*kg, 0*g ).count() )eq( INT_MIN );
+		expect( add( overflow::saturating{}, UINT_MAX*kg, 0u*g ).count() )eq( UINT_MAX );
+		expect( add( overflow::unchecked{}, UINT_MAX*kg, 0u*g ).count() )eq( UINT_MAX-999 );
+		expect( equal( overflow::saturating{}, 1*kg, 1000*g ) )eq( true );
+	}
+	{
+		setup( const auto wide = add( overflow::widening{}, INT_MAX*kg, 1*g ) );
+		cexpect( is_same< decltype(wide.count()), const std::int64_t & >::value );
+		expect( wide.count() )eq( std::int64_t{INT_MAX}*1000 + 1 );
+		expect( wide.unit == g )eq( true );
+		setup( const auto w16 = add( overflow::widening{}, std::int16_t{100}*s, std::int16_t{1}*(milli*s) ) );
+		cexpect( is_same< decltype(w16.count()), const std::int32_t & >::value );
+		expect( w16.count() )eq( 100'001 );
+		// by size and signedness, whatever the spelling
+		using dimensional::widened;
+		cexpect( is_same< widened<char>::type, std::conditional_t< std::is_signed<char>::value,
+			std::int16_t, std::uint16_t > >::value );
+		cexpect( sizeof(widened<long long>::type) == 2*sizeof(long long) );
+		cexpect( sizeof(widened<unsigned long>::type) == 2*sizeof(unsigned long) );
+		setup( const auto wll = add( overflow::widening{}, (LLONG_MAX/1000)*kg, 1LL*g ) );
+		expect( wll.count() > LLONG_MAX/1000 )eq( true );
+	}
+	{
+		// per data type
+		setup( const short k = 100 );
+		expect( throws<std::overflow_error>( [&]{ k*kg + short{1}*g; } ) )eq( true );
+		expect( throws<std::overflow_error>( [&]{ k*kg < short{1}*g; } ) )eq( true );
+		expect( (short{10}*kg + short{1}*g).count() )eq( 10'001 );
+		setup( quantity_vector<short, decltype(kilo*g)> a{ k*kg } );
+		setup( quantity_vector<short, std::decay_t<decltype(g)>> b{ short{1}*g } );
+		expect( throws<std::overflow_error>( [&]{ dimensional::add( a.cspan(), b.cspan() ); } ) )eq( true );
+	}
+}
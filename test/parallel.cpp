@@ -0,0 +1,76 @@
+#include "../include/dimensional/parallel.hpp"
+#include "../include/dimensional/bulk.hpp"
+#include "../include/dimensional/si.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "test.hpp"
+test
+{
+	using namespace si;
+	using dimensional::quantity_vector;
+	using dimensional::par::thread_pool;
+	namespace par = dimensional::par;
+	using meta::is_same;
+
+	using mW  = decltype(milli*W);
+	using ms  = decltype(milli*s);
+	using us  = decltype(micro*s);
+
+	setup( thread_pool pool{ 4 } );
+	expect( pool.size() )eq( 4u );
+	setup( constexpr std::size_t n = 100'003 );  // several chunks, uneven
+	{
+		// a day's worth of energy from power samples, one every millisecond
+		setup( quantity_vector<std::int64_t, mW> p( n, 1500*(milli*W) ) );
+		setup( const auto e = par::transform_reduce( pool, p, std::int64_t{0}*J, std::plus<>{},
+			[]( auto x ) { return x * (1*(milli*s)); } ) );
+		cexpect( is_same< decltype(e), const decltype(std::int64_t{0}*J + p[0].get()*(1*(milli*s))) >::value );
+		expect( e.count() )eq( 1500 * std::int64_t{n} );
+		expect( e == std::int64_t{n}*(1500*(micro*J)) )eq( true );
+	}
+	{
+		setup( quantity_vector<std::int64_t, ms> t( n, 1*(milli*s) ) );
+		setup( const auto sum = par::reduce( pool, t ) );
+		cexpect( is_same< decltype(sum), const decltype(std::int64_t{1}*(milli*s)) >::value );
+		expect( sum.count() )eq( std::int64_t{n} );
+		// the partial sums are in the common unit of init and the elements
+		setup( const auto fine = par::reduce( pool, t, 3*(micro*s) ) );
+		cexpect( is_same< decltype(fine), const decltype(std::int64_t{1}*(milli*s) + std::int64_t{1}*(micro*s)) >::value );
+		expect( fine.count() )eq( std::int64_t{n}*1000 + 3 );
+		expect( par::reduce( thread_pool::shared(), t ) == sum )eq( true );
+		expect( par::reduce( t ) == sum )eq( true );
+	}
+	{
+		setup( std::vector<decltype(1.0*unit::m)> a( n, 2.0*unit::m ) );
+		setup( quantity_vector<double, decltype(kilo*N)> f( n, 0.5*(kilo*N) ) );
+		setup( const auto work = par::transform_reduce( pool, a, f, 0.0*J ) );
+		expect( work.to( J ).count() )eq( 1000.0 * n );
+	}
+	{
+		setup( quantity_vector<std::int64_t, ms> t( n ) );
+		setup( for ( std::size_t i = 0; i < n; ++i ) t[i] = std::int64_t(i)*(milli*s) );
+		setup( quantity_vector<std::int64_t, us> shifted( n ) );
+		setup( par::transform( pool, t, shifted, []( auto x ) { return x + 1*(micro*s); } ) );
+		expect( shifted.data()[n-1] )eq( std::int64_t(n-1)*1000 + 1 );
+		setup( quantity_vector<std::int64_t, us> total( n ) );
+		setup( par::inclusive_scan( pool, shifted, total ) );
+		setup( bool same = true );
+		setup( std::int64_t run = 0 );
+		setup( for ( std::size_t i = 0; i < n; ++i )
+			run += shifted.data()[i], same = same && total.data()[i] == run );
+		expect( same )eq( true );
+		setup( std::vector<std::int64_t> raw( n, 1 ), scan( n ) );
+		setup( par::inclusive_scan( raw, scan ) );
+		expect( scan.back() )eq( std::int64_t{n} );
+	}
+	{
+		setup( std::vector<int> v( n ) );
+		setup( bool thrown = false );
+		setup( try { par::transform( pool, v, v, []( int ) -> int { throw std::runtime_error{"x"}; } ); }
+			catch ( const std::runtime_error & ) { thrown = true; } );
+		expect( thrown )eq( true );
+		expect( par::reduce( pool, std::vector<int>{} ) )eq( 0 );
+	}
+}
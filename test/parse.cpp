@@ -0,0 +1,110 @@
+#include "../include/dimensional/parse.hpp"
+#include "../include/dimensional/si.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	bool fails( const std::string &text )
+	{
+		try
+		{
+			dimensional::parse_unit( text );
+		}
+		catch ( const dimensional::unit_parse_error & )
+		{
+			return true;
+		}
+		return false;
+	}
+}
+
+#include "test.hpp"
+test
+{
+	using namespace si;
+	using dimensional::parse_unit;
+	using dimensional::dyn_unit;
+	using dimensional::dyn_dimension;
+	using dimensional::rational;
+
+	{
+		expect( parse_unit( "kg*m/s^2" ).is( N ) )eq( true );
+		expect( parse_unit( "kg m s^-2" ) == N )eq( true );
+		expect( parse_unit( "1852/1000 k m" ).is( 1852_*unit::m ) )eq( true );
+		expect( parse_unit( "km/h" ).scale == rational{ 5, 18 } )eq( true );
+		expect( parse_unit( "km/h" ).dimension == length/si::time )eq( true );
+		expect( parse_unit( "0.3048 m" ).scale == rational{ 381, 1250 } )eq( true );
+		expect( parse_unit( "mm" ).is( milli*unit::m ) )eq( true );
+		expect( parse_unit( "m" ).is( unit::m ) )eq( true );
+		expect( parse_unit( "ms" ).is( milli*s ) )eq( true );
+		expect( parse_unit( "kilometre" ).is( kilo*unit::m ) )eq( true );
+		expect( parse_unit( "dam" ).is( deca*unit::m ) )eq( true );
+		expect( parse_unit( "hm" ).is( hecto*unit::m ) )eq( true );
+		expect( parse_unit( "h" ).is( 3600_*s ) )eq( true );
+		expect( parse_unit( "µs" ).is( micro*s ) )eq( true );
+		expect( parse_unit( "kΩ" ).is( kilo*O ) )eq( true );
+		expect( parse_unit( "J/(kg K)" ).is( J/(kg*K) ) )eq( true );
+		expect( parse_unit( "(km^2)^(1/2)" ).is( kilo*unit::m ) )eq( true );
+		expect( parse_unit( "1000" ) == dyn_unit{ dyn_dimension{}, 1000 } )eq( true );
+	}
+	{
+		// parsed once, up to capacity
+		setup( dimensional::unit_parser parser{ dimensional::si_symbols(), 2 } );
+		setup( const dyn_unit a = parser.parse( "kN*m" ) );
+		expect( parser.parse( "kN*m" ) == a )eq( true );
+		expect( parser.size() )eq( 1u );
+		expect( parser.parse( "kN m" ) == a )eq( true );
+		expect( parser.size() )eq( 2u );
+		expect( parser.parse( "kJ" ) == a )eq( true );
+		expect( parser.parse( "kJ" ).is( kilo*J ) )eq( true );
+		expect( parser.size() )eq( 2u );
+	}
+	{
+		expect( fails( "" ) )eq( true );
+		expect( fails( "furlong" ) )eq( true );
+		expect( fails( "kg*" ) )eq( true );
+		expect( fails( "(m" ) )eq( true );
+		expect( fails( "m^" ) )eq( true );
+		expect( fails( "m^(1/0)" ) )eq( true );
+		expect( fails( "(2 m)^(1/2)" ) )eq( true );
+		expect( fails( "m s)" ) )eq( true );
+		expect( fails( "0 m" ) )eq( true );
+		expect( fails( "1/0" ) )eq( true );
+		expect( fails( "m/0.0" ) )eq( true );
+		expect( fails( "k^10" ) )eq( true );
+		expect( fails( "m^3074457345618258603" ) )eq( true );
+		expect( fails( "2^999999999999999999" ) )eq( true );
+		expect( fails( "9223372036854775.808" ) )eq( true );
+		expect( fails( "1^999999999999999999" ) )eq( false );
+		expect( fails( "4^(1/999999999999)" ) )eq( true );
+		expect( fails( "kg*m/s^2" ) )eq( false );
+	}
+	{
+		// symbols of one's own
+		setup( dimensional::unit_symbols money );
+		setup( money.add_unit( "USD", dyn_dimension::base( "USD" ) ) );
+		setup( money.add_prefix( "k", 1000 ) );
+		setup( dimensional::unit_parser parser{ money } );
+		expect( parser.parse( "kUSD" ) == dyn_unit{ dyn_dimension::base( "USD" ), 1000 } )eq( true );
+		expect( parser.parse( "kUSD/k" ).scale == rational{ 1 } )eq( true );
+		expect( parser.parse( "kUSD" ).dimension == dyn_dimension::base( "USD" ) )eq( true );
+	}
+	{
+		// from many threads at once
+		setup( dimensional::unit_parser parser{ dimensional::si_symbols() } );
+		setup( std::vector<dyn_unit> seen( 8 ) );
+		setup( std::vector<std::thread> threads );
+		for ( std::size_t i = 0; i < seen.size(); ++i )
+			threads.emplace_back( [&parser, &seen, i]{
+				for ( int j = 0; j < 1000; ++j )
+					seen[i] = parser.parse( "W/m^2/" + std::to_string( j % 50 + 1 ) );
+			} );
+		for ( auto &t : threads )
+			t.join();
+		expect( parser.size() )eq( 50u );
+		expect( seen[0] == seen[7] )eq( true );
+		expect( seen[0].is( (1_/50_)*(W/(unit::m*unit::m)) ) )eq( true );
+	}
+}
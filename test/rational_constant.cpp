@@ -1,5 +1,7 @@
 
+#include <cmath>
 #include <cstdint>
+#include <limits>
 #include "../include/dimensional/impl/rational_constant.hpp"
 
 #include "test.hpp"
@@ -33,11 +35,26 @@ test
 	expect( 00.1_ )eq( ratio<1,8>{} );
 	expect( 00.01_ )eq( ratio<1,64>{} );
 	expect( 00.11_ )eq( ratio<9,64>{} );
-#if 0
-	// TODO: scientific format support
 	expect( 0.1e0_ )eq( ratio<1,10>{} );
+	expect( 1e3_ )eq( ratio<1000,1>{} );
+	expect( 1E3_ )eq( ratio<1000,1>{} );
+	expect( 1e+3_ )eq( ratio<1000,1>{} );
+	expect( 1e-3_ )eq( ratio<1,1000>{} );
+	expect( 0e5_ )eq( ratio<0,1>{} );
+	expect( 2.5e-1_ )eq( ratio<1,4>{} );
+	expect( 6.02214076e8_ )eq( ratio<602214076,1>{} );
+	expect( 1.602176634e-1_ )eq( ratio<801088317,5'000'000'000>{} );
+	expect( 1e18_ )eq( ratio<1'000'000'000'000'000'000,1>{} );
+	expect( 0.000000000000000001e18_ )eq( ratio<1,1>{} );
+#if __cplusplus >= 201703L
+	// hexadecimal floating literals are only standard since C++17
 	expect( 0x0.1p0_ )eq( ratio<1,16>{} );
+	expect( 0x1p4_ )eq( ratio<16,1>{} );
+	expect( 0x1p-4_ )eq( ratio<1,16>{} );
+	expect( 0xA.8p0_ )eq( ratio<21,2>{} );
+	expect( 0x1P62_ )eq( ratio<(intmax_t{1} << 62),1>{} );
 #endif
+	expect( 1.50000000000000000000000000_ )eq( ratio<3,2>{} );
 
 	expect( 0b111111111111111111111111111111111111111111111111111111111111111_ )
 		eq( ratio<INT64_MAX,1>{} );
@@ -46,12 +63,8 @@ test
 	expect( 0x7fffffffffffffff_ )eq( ratio<INT64_MAX,1>{} );
 	expect( 0X7fFfFfFfFfFfFfFf_ )eq( ratio<INT64_MAX,1>{} );
 
-#if 0
-	// FIXME: leading zeroes may cause overflow
-	// possible fix: trim them
-	// a better one: dispatch on zero/non-zero digit before exponentiating the base
 	expect( 0x0'0000'0000'0000'0000_ )eq( ratio<0,1>{} );
-#endif
+	expect( 0x0'0000'0000'0000'0001_ )eq( ratio<1,1>{} );
 
 	using meta::root;
 	// ^ The declaration works around gcc bug #67835 (or
@@ -110,4 +123,22 @@ test
 	expect( root( 2_, -1_) )eq( 1_/2_);
 	expect( root( 4_, -2_) )eq( 1_/2_);
 	expect( root( 8_, -3_) )eq( 1_/2_);
+
+	expect( pow( 32_, 1_/ 5_) )eq( 2_);
+	expect( pow( 128_, 3_/ 7_) )eq( 8_);
+	expect( root( -243_, 5_) )eq( -3_);
+	expect( root( 1_/ 243_, -5_) )eq( 3_);
+	expect( root( 3'486'784'401_, 20_) )eq( 3_);
+	expect( root( 9'223'372'036'854'775'807_, 1_) )eq( 9'223'372'036'854'775'807_);
+	// greatest 7th power that fits into 64-bit signed integer
+	expect( root( 9'098'007'718'612'700'671_, 7_) )eq( 511_);
+
+	expect( mjk::root( 32.0, mjk::intmax_constant<5>{} ) )eq( 2.0 );
+	expect( mjk::root( -243.0, mjk::intmax_constant<5>{} ) )eq( -3.0 );
+	expect( mjk::root( 78'125.0f, mjk::intmax_constant<7>{} ) )eq( 5.0f );
+	// no Newton step where the powers don't fit
+	constexpr auto inf = std::numeric_limits<double>::infinity();
+	expect( mjk::root( inf, mjk::intmax_constant<5>{} ) )eq( inf );
+	expect( mjk::root( -inf, mjk::intmax_constant<5>{} ) )eq( -inf );
+	expect( std::isfinite( mjk::root( std::numeric_limits<double>::max(), mjk::intmax_constant<5>{} ) ) )eq( true );
 }
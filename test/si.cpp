@@ -16,6 +16,12 @@ test
 		cexpect( kgf.dimension == mass*length/(si::time^2_) );
 	}
 
+	{
+		constexpr auto u = (32_*(metre^5_))^(1_/5_);
+		cexpect( u.scale == 2_ );
+		cexpect( u.dimension == length );
+	}
+
 	{
 		constexpr auto ns = nano*s;
 
@@ -0,0 +1,35 @@
+#define DIMENSIONAL_NAMED_DIMENSIONS
+
+// an interface spelled with the forward declarations only
+#include "../include/dimensional/si_fwd.hpp"
+si::quantities::work<> work_done( const si::quantities::force<> &,
+                                  const si::quantities::length<> & );
+
+#include "../include/dimensional/si.hpp"
+
+si::quantities::work<> work_done( const si::quantities::force<> &f,
+                                  const si::quantities::length<> &d )
+{
+	return f*d;
+}
+
+#include "test.hpp"
+test
+{
+	using namespace si;
+	using meta::is_same;
+
+	cexpect( is_same< decltype(1.0*N), quantities::force<> >::value );
+	cexpect( is_same< decltype(1.0f*Pa), quantities::pressure<float> >::value );
+	cexpect( is_same< decltype(std::int64_t{}*kat),
+		quantities::catalytic_activity<std::int64_t> >::value );
+
+	{
+		setup( const auto res = work_done( 2.0*N, 3.0*unit::m ) );
+		expect( res.count() )eq( 6.0 );
+	}
+	{
+		setup( const auto res = 1.5f*V + 2.5f*V );
+		expect( res.count() )eq( 4.0f );
+	}
+}
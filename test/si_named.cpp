@@ -0,0 +1,59 @@
+#define DIMENSIONAL_NAMED_DIMENSIONS
+#include "../include/dimensional/si.hpp"
+
+template<typename Unit>
+using dimension_of = typename std::decay<decltype(Unit::dimension)>::type;
+
+#include "test.hpp"
+test
+{
+	using namespace si;
+	using namespace std::chrono;
+	using dimensional::constant;
+	using meta::is_same;
+
+	cexpect( is_same< dimension_of<decltype(unit::m)>,   named::length >::value );
+	cexpect( is_same< dimension_of<decltype(A)>,   named::current >::value );
+	cexpect( is_same< dimension_of<decltype(Hz)>,  named::frequency >::value );
+	cexpect( is_same< dimension_of<decltype(N)>,   named::force >::value );
+	cexpect( is_same< dimension_of<decltype(Pa)>,  named::pressure >::value );
+	cexpect( is_same< dimension_of<decltype(J)>,   named::work >::value );
+	cexpect( is_same< dimension_of<decltype(W)>,   named::mechanical_power >::value );
+	cexpect( is_same< dimension_of<decltype(unit::C)>,   named::charge >::value );
+	cexpect( is_same< dimension_of<decltype(V)>,   named::voltage >::value );
+	cexpect( is_same< dimension_of<decltype(unit::F)>,   named::capacitance >::value );
+	cexpect( is_same< dimension_of<decltype(O)>,   named::resistance >::value );
+	cexpect( is_same< dimension_of<decltype(S)>,   named::conductance >::value );
+	cexpect( is_same< dimension_of<decltype(Wb)>,  named::magnetic_flux >::value );
+	cexpect( is_same< dimension_of<decltype(unit::T)>,   named::magnetic_flux_density >::value );
+	cexpect( is_same< dimension_of<decltype(H)>,   named::inductance >::value );
+	cexpect( is_same< dimension_of<decltype(lx)>,  named::illuminance >::value );
+	cexpect( is_same< dimension_of<decltype(Gy)>,  named::absorbed_dose >::value );
+	cexpect( is_same< dimension_of<decltype(kat)>, named::catalytic_activity >::value );
+	cexpect( is_same< decltype(+(power*si::time)), named::energy >::value );
+	cexpect( is_same< decltype(+flow), named::flow >::value );
+
+	// named and unnamed spellings interoperate
+	cexpect( power*si::time == energy );
+	cexpect( named::force{} == mass*length/(si::time^2_) );
+	cexpect( (unit::m/s).dimension == named::velocity{} );
+
+	{
+		setup( const auto res = 1.5*N * (2.0*unit::m) );
+		expect( res.count() )eq( 3.0 );
+		cexpect( is_same< dimension_of<decltype(res.unit)>, named::work >::value );
+	}
+	{
+		setup( const auto res = 1.0*(kilo*N) + 1.0*N );
+		expect( res.to(N.scale).count() )eq( 1001.0 );
+	}
+	{
+		setup( nanoseconds res = 1729*(nano*s) );
+		expect( res.count() )eq( 1729 );
+	}
+	{
+		using is = decltype(intmax_t{}*s);
+		setup( is res = minutes{1} );
+		expect( res.count() )eq( 60 );
+	}
+}
@@ -0,0 +1,161 @@
+#include "../include/dimensional/bulk.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using dimensional::constant;
+	using dimensional::impl::convert_raw;
+	namespace simd = dimensional::impl::simd;
+
+	template<typename T>
+	std::vector<T> samples( std::size_t n )
+	{
+		std::mt19937_64 gen{ 1729 };
+		std::vector<T> res( n );
+		for ( auto &x : res )
+			x = static_cast<T>( gen() );
+		if ( n > 2 )
+			res[0] = std::numeric_limits<T>::lowest(),
+			res[1] = std::numeric_limits<T>::max(),
+			res[2] = T{};
+		return res;
+	}
+	// small enough not to overflow when scaled
+	template<>
+	std::vector<std::int64_t> samples( std::size_t n )
+	{
+		std::mt19937_64 gen{ 1729 };
+		std::uniform_int_distribution<std::int64_t> dist{ -(std::int64_t{1} << 40), std::int64_t{1} << 40 };
+		std::vector<std::int64_t> res( n );
+		for ( auto &x : res )
+			x = dist( gen );
+		return res;
+	}
+	template<>
+	std::vector<float> samples( std::size_t n )
+	{
+		std::mt19937_64 gen{ 1729 };
+		std::uniform_real_distribution<float> dist{ -1e6f, 1e6f };
+		std::vector<float> res( n );
+		for ( auto &x : res )
+			x = dist( gen );
+		return res;
+	}
+	template<>
+	std::vector<double> samples( std::size_t n )
+	{
+		std::mt19937_64 gen{ 1729 };
+		std::uniform_real_distribution<double> dist{ -1e12, 1e12 };
+		std::vector<double> res( n );
+		for ( auto &x : res )
+			x = dist( gen );
+		return res;
+	}
+
+	// every instruction set available gives the scalar loop's values,
+	// with odd sizes to leave tails
+	template<typename T, typename From, typename To>
+	bool same_as_scalar()
+	{
+		const auto in = samples<T>( 1037 );
+		std::vector<T> want( in.size() );
+		convert_raw<From, To, T, T>( in.data(), in.size(), want.data() );
+		for ( auto with : { simd::isa::scalar, simd::isa::sse2, simd::isa::avx2, simd::isa::avx512 } )
+		{
+			if ( with > simd::level() )
+				break;
+			std::vector<T> got( in.size() );
+			convert_raw<From, To>( in.data(), in.size(), got.data(), with );
+			if ( got != want )
+				return false;
+		}
+		return true;
+	}
+
+	// likewise for the binary operations on quantities of different scales
+	template<typename T, typename ScaleA, typename ScaleB, typename Op>
+	bool same_as_scalar( Op op )
+	{
+		using dimensional::impl::heterop_n;
+		const auto a = samples<T>( 1037 );
+		auto b = samples<T>( 1038 );
+		b.erase( b.begin() );
+		using R = decltype( op(T{}, T{}) );
+		std::unique_ptr<R[]> want{ new R[a.size()] }, got{ new R[a.size()] };
+		heterop_n<ScaleA, ScaleB>( op, a.data(), b.data(), a.size(), want.get(), simd::isa::scalar );
+		for ( auto with : { simd::isa::sse2, simd::isa::avx2, simd::isa::avx512 } )
+		{
+			if ( with > simd::level() )
+				break;
+			heterop_n<ScaleA, ScaleB>( op, a.data(), b.data(), a.size(), got.get(), with );
+			if ( !std::equal( want.get(), want.get() + a.size(), got.get() ) )
+				return false;
+		}
+		return true;
+	}
+
+	template<std::int32_t D>
+	bool divides()
+	{
+		const auto in = samples<std::int32_t>( 4096 );
+		for ( auto n : in )
+			if ( simd::divide<D>( n ) != n / D )
+				return false;
+		return true;
+	}
+}
+
+#include "test.hpp"
+test
+{
+	using milli = constant<1,1000>;
+	using kilo  = constant<1000>;
+	using one   = constant<1>;
+	using inch  = constant<127,5000>;
+
+	expect( same_as_scalar< float,  milli, one >() )eq( true );
+	expect( same_as_scalar< float,  one, milli >() )eq( true );
+	expect( same_as_scalar< float,  inch, milli >() )eq( true );
+	expect( same_as_scalar< double, milli, kilo >() )eq( true );
+	expect( same_as_scalar< double, inch, one >() )eq( true );
+
+	expect( same_as_scalar< std::int32_t, one, milli >() )eq( true );
+	expect( same_as_scalar< std::int32_t, milli, one >() )eq( true );
+	expect( same_as_scalar< std::int32_t, constant<1,7>, one >() )eq( true );
+	expect( same_as_scalar< std::int32_t, constant<1,641>, one >() )eq( true );
+	expect( same_as_scalar< std::int32_t, constant<1,0x40000000>, one >() )eq( true );
+	expect( same_as_scalar< std::int32_t, inch, one >() )eq( true );
+	expect( same_as_scalar< std::int32_t, constant<1,1024>, one >() )eq( true );
+	expect( same_as_scalar< std::int32_t, constant<3,1024>, one >() )eq( true );
+
+	expect( same_as_scalar< std::int64_t, one, constant<1,1000000> >() )eq( true );
+	expect( same_as_scalar< std::int64_t, constant<-3>, one >() )eq( true );
+	expect( same_as_scalar< std::int64_t, milli, one >() )eq( true );
+	expect( same_as_scalar< std::int64_t, constant<1,1024>, one >() )eq( true );
+	expect( same_as_scalar< std::int64_t, constant<1,(std::int64_t{1} << 40)>, one >() )eq( true );
+	expect( same_as_scalar< std::int64_t, constant<1024>, one >() )eq( true );
+	expect( same_as_scalar< double, constant<1,1024>, constant<1000> >() )eq( true );
+
+	expect( same_as_scalar< float, milli, one >( mjk::plus ) )eq( true );
+	expect( same_as_scalar< float, inch, milli >( mjk::minus ) )eq( true );
+	expect( same_as_scalar< double, milli, kilo >( mjk::less ) )eq( true );
+	expect( same_as_scalar< double, one, one >( mjk::equal_to ) )eq( true );
+	expect( same_as_scalar< std::int32_t, one, milli >( mjk::plus ) )eq( true );
+	expect( same_as_scalar< std::int32_t, inch, milli >( mjk::less ) )eq( true );
+	expect( same_as_scalar< std::int64_t, constant<1,1000>, constant<1,1000000> >( mjk::minus ) )eq( true );
+	expect( same_as_scalar< std::int64_t, kilo, one >( mjk::equal_to ) )eq( true );
+
+	expect( divides<2>() )eq( true );
+	expect( divides<3>() )eq( true );
+	expect( divides<7>() )eq( true );
+	expect( divides<1000>() )eq( true );
+	expect( divides<INT32_MAX>() )eq( true );
+	expect( simd::divide<7>( INT32_MIN ) )eq( INT32_MIN / 7 );
+	expect( simd::divide<7>( -7 ) )eq( -1 );
+	expect( simd::divide<7>( -6 ) )eq( 0 );
+}
@@ -67,6 +67,21 @@ struct testerL
 	}
 };
 
+// whether f throws an Exception
+template<typename Exception, typename F>
+bool throws( F f )
+{
+	try
+	{
+		f();
+	}
+	catch ( const Exception & )
+	{
+		return true;
+	}
+	return false;
+}
+
 #define test \
 	template<typename F> \
 	void test( F ); \
@@ -86,7 +101,7 @@ struct testerL
 	template<typename F> \
 	void test( F expect )
 
-#define setup( statement ) std::cerr << #statement << ";\n"; statement
+#define setup( ... ) std::cerr << #__VA_ARGS__ << ";\n"; __VA_ARGS__
 #define expect( ... ) expect( (__VA_ARGS__), #__VA_ARGS__ )
 #define eq( ... )   .eq( (__VA_ARGS__), #__VA_ARGS__ )
 #define cexpect( ... ) static_assert( (__VA_ARGS__), #__VA_ARGS__ )